@@ -1,12 +1,18 @@
 // Renderer 2D Quad Shader
 #version 450 core
 
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec4 a_Color;
-layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in float a_TexIndex;
-layout(location = 4) in float a_TilingFactor;
-layout(location = 5) in int a_EntityID;
+// Per-vertex: corner of the unit quad
+layout(location = 0) in vec2 a_Position;
+
+// Per-instance
+layout(location = 1) in vec3 a_Right;
+layout(location = 2) in vec3 a_Up;
+layout(location = 3) in vec3 a_Origin;
+layout(location = 4) in vec4 a_Color;         // RGBA8
+layout(location = 5) in vec4 a_TexRect;       // unorm16
+layout(location = 6) in uvec2 a_TexIndex;     // x = index, y = array layer
+layout(location = 7) in vec2 a_TilingFactor;  // Half float, y unused
+layout(location = 8) in int a_EntityID;       // Absent in Dist builds
 
 layout(std140, binding = 0) uniform Camera
 {
@@ -23,14 +29,17 @@ struct VertexOutput
 layout (location = 0) out VertexOutput Output;
 layout (location = 3) out flat float v_TexIndex;
 layout (location = 4) out flat int v_EntityID;
+layout (location = 5) out flat float v_TexLayer;
 
 void main()
 {
 	Output.Color = a_Color;
-	Output.TexCoord = a_TexCoord;
-	Output.TilingFactor = a_TilingFactor;
-	v_TexIndex = a_TexIndex;
+	Output.TexCoord = mix(a_TexRect.xy, a_TexRect.zw, a_Position + 0.5);
+	Output.TilingFactor = a_TilingFactor.x;
+	v_TexIndex = float(a_TexIndex.x);
+	v_TexLayer = float(a_TexIndex.y);
 	v_EntityID = a_EntityID;
 
-	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+	vec3 worldPosition = a_Origin + a_Right * a_Position.x + a_Up * a_Position.y;
+	gl_Position = u_ViewProjection * vec4(worldPosition, 1.0);
 }
\ No newline at end of file
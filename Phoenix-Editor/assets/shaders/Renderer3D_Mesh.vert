@@ -1,4 +1,4 @@
-// Renderer 2D Quad Shader
+// Renderer 3D Mesh Shader
 #version 450 core
 
 layout(location = 0) in vec3 a_Position;
@@ -6,12 +6,18 @@ layout(location = 1) in vec4 a_Color;
 layout(location = 2) in vec2 a_TexCoord;
 layout(location = 3) in float a_TexIndex;
 layout(location = 4) in float a_TilingFactor;
-layout(location = 5) in int a_EntityID;
+layout(location = 6) in int a_ObjectIndex; // Per-instance, set through the base instance
 
-layout(std140, binding = 0) uniform Camera
+layout(std140, binding = 2) uniform Camera
 {
 	mat4 u_ViewProjection;
-	mat4 u_Transform;
+};
+
+// Renderer3D::MaxObjectsPerBatch objects
+layout(std140, binding = 3) uniform Objects
+{
+	mat4 u_Transforms[128];
+	ivec4 u_EntityIDs[32];
 };
 
 struct VertexOutput
@@ -31,8 +37,7 @@ void main()
 	Output.TexCoord = a_TexCoord;
 	Output.TilingFactor = a_TilingFactor;
 	v_TexIndex = a_TexIndex;
-	v_EntityID = a_EntityID;
+	v_EntityID = u_EntityIDs[a_ObjectIndex / 4][a_ObjectIndex % 4];
 
-	vec4 pos = vec4(a_Position, 1.0);
-	gl_Position = u_ViewProjection * pos;
+	gl_Position = u_ViewProjection * u_Transforms[a_ObjectIndex] * vec4(a_Position, 1.0);
 }
\ No newline at end of file
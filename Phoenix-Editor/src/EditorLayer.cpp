@@ -38,7 +38,11 @@ namespace phx
 		m_PlayTestIcon = Texture2D::Create("resources/icons/editor-layer/playtest-icon.png");
 		
 		FramebufferSpecification framebufferSpec;
+#ifdef PHX_RENDERER_ENTITY_ID
 		framebufferSpec.Attachments = { FramebufferTextureFormat::RGBA8, FramebufferTextureFormat::RED_INTEGER, FramebufferTextureFormat::Depth };
+#else
+		framebufferSpec.Attachments = { FramebufferTextureFormat::RGBA8, FramebufferTextureFormat::Depth };
+#endif
 		framebufferSpec.Width = 1280;
 		framebufferSpec.Height = 720;
 		m_Framebuffer = Framebuffer::Create(framebufferSpec);
@@ -106,12 +110,19 @@ namespace phx
 
 
 		Renderer2D::ResetStats();
+		Renderer3D::ResetStats();
+		RenderCommand::ResetStateStats();
+		RenderCommandQueue::ResetStats();
 
+		// Lasts until the framebuffer is unbound at the end of the update
+		GPUProfileScope gpuScope("Viewport");
 		m_Framebuffer->Bind();
 		RenderCommand::ClearColor({ 0.12, 0.12, 0.12, 1 });
 		RenderCommand::Clear();
 
+#ifdef PHX_RENDERER_ENTITY_ID
 		m_Framebuffer->ClearAttachment(1, -1);
+#endif
 		//Renderer2D::BeginScene(m_CameraController.GetCamera());
 
 		switch (m_SceneState)
@@ -146,11 +157,39 @@ namespace phx
 		int mouseX = (int)mx;
 		int mouseY = (int)my;
 
+#ifdef PHX_RENDERER_ENTITY_ID
 		if (mouseX >= 0 && mouseY >= 0 && mouseX < (int)viewportSize.x && mouseY < (int)viewportSize.y)
 		{
-			int pixelData = m_Framebuffer->ReadPixel(1, mouseX, mouseY);
-			m_HoveredEntity = pixelData == -1 ? Entity() : Entity((entt::entity)pixelData, m_ActiveScene.get());
+			glm::ivec2 mousePosition = { mouseX, mouseY };
+			if ((mousePosition != m_LastPickPosition || m_SelectionPickPending) && m_Framebuffer->RequestPixel(1, mouseX, mouseY))
+			{
+				m_PickRequests.push_back({ m_ActiveScene, m_SelectionPickPending });
+				m_LastPickPosition = mousePosition;
+				m_SelectionPickPending = false;
+			}
+		}
+		else
+		{
+			m_SelectionPickPending = false;
+		}
+
+		int pixelData;
+		while (!m_PickRequests.empty() && m_Framebuffer->PollPixel(pixelData))
+		{
+			PickRequest request = m_PickRequests.front();
+			m_PickRequests.pop_front();
+
+			// Entities of a scene swapped out since the request mean nothing now
+			if (request.Scene != m_ActiveScene)
+				continue;
+
+			// A result read before a deletion may still name the deleted entity
+			entt::entity handle = (entt::entity)pixelData;
+			m_HoveredEntity = m_ActiveScene->IsValid(handle) ? Entity(handle, m_ActiveScene.get()) : Entity();
+			if (request.Select)
+				m_SceneHierarchyPanel.SetSelectedEntity(m_HoveredEntity);
 		}
+#endif
 
 		//Renderer2D::EndScene();
 		OnOverlayRender();
@@ -281,6 +320,9 @@ namespace phx
 		ImGui::End();*/
 
 		m_SceneHierarchyPanel.OnImGuiRender();
+		// The panel deletes entities without telling the viewport
+		if (m_HoveredEntity && !m_ActiveScene->IsValid(m_HoveredEntity))
+			DiscardPicks();
 
 		if (m_ShowContentBrowser)
 			m_ContentBrowserPanel.OnImGuiRender();
@@ -309,7 +351,7 @@ namespace phx
 				highfps = fps;
 
 			auto stats = Renderer2D::GetStats();
-			//auto stats3d = Renderer3D::GetStats();
+			auto stats3d = Renderer3D::GetStats();
 
 			ImGui::Text("FPS: %.0f", fps);
 			ImGui::SameLine();
@@ -332,6 +374,25 @@ namespace phx
 			ImGui::Text("Vertices: %d", stats.GetTotalVertexCount());
 			ImGui::Text("Indices: %d", stats.GetTotalIndexCount());
 			ImGui::Separator();
+			ImGui::Text("Renderer3D Stats");
+			ImGui::Text("Draw Calls: %d", stats3d.DrawCalls);
+			ImGui::Text("Indirect Draws: %d", stats3d.IndirectDrawCount);
+			ImGui::Text("Meshes: %d", stats3d.MeshCount);
+			ImGui::Text("Culled Meshes: %d", stats3d.CulledMeshCount);
+			ImGui::Text("Occluded Meshes: %d", stats3d.OccludedMeshCount);
+			ImGui::Text("Triangles: %d", stats3d.TriangleCount);
+			ImGui::Separator();
+			auto stateStats = RenderCommand::GetStateStats();
+			ImGui::Text("GL State Calls");
+			ImGui::Text("Issued: %d", stateStats.IssuedCalls);
+			ImGui::Text("Elided: %d", stateStats.ElidedCalls);
+			auto queueStats = RenderCommandQueue::GetStats();
+			ImGui::Text("Command Buffers: %d (%d commands)", queueStats.BufferCount, queueStats.CommandCount);
+			ImGui::Separator();
+			ImGui::Text("GPU Time: %.3f ms", GPUProfiler::GetFrameMilliseconds());
+			for (const auto& pass : GPUProfiler::GetPassTimes())
+				ImGui::Text("%*s%s: %.3f ms", (int)pass.Depth * 2, "", pass.Name, pass.Milliseconds);
+			ImGui::Separator();
 
 			ImGui::Text("Scene Stats");
 			ImGui::Text("Registry Size: %d", m_ActiveScene->GetRegistrySize());
@@ -437,6 +498,8 @@ namespace phx
 					tc.Translation = translation;
 					tc.Rotation += deltaRotation;
 					tc.Scale = scale;
+
+					m_ActiveScene->MarkRenderableDirty(selectedEntity);
 				}
 			}
 		}
@@ -619,6 +682,7 @@ namespace phx
 			{
 				m_ActiveScene->DestroyEntity(m_SceneHierarchyPanel.GetSelectedEntity());
 				m_SceneHierarchyPanel.SetSelectedEntity();
+				DiscardPicks();
 			}
 			break;
 		}
@@ -636,11 +700,22 @@ namespace phx
 		if (e.GetMouseButton() == (int)Mouse::ButtonLeft)
 		{
 			if (m_ViewportHovered && !ImGuizmo::IsOver() && !Input::IsKeyPressed(Key::LeftAlt))
-				m_SceneHierarchyPanel.SetSelectedEntity(m_HoveredEntity);
+				m_SelectionPickPending = true;
 		}
 		return false;
 	}
 
+	void EditorLayer::DiscardPicks()
+	{
+		// Reads in flight still come back in order, so their requests stay queued and are ignored like those of a
+		// swapped out scene. Forgetting the position picks again under the mouse even if it does not move
+		for (PickRequest& request : m_PickRequests)
+			request.Scene = nullptr;
+
+		m_HoveredEntity = {};
+		m_LastPickPosition = { -1, -1 };
+	}
+
 	void EditorLayer::OnOverlayRender()
 	{
 		if (m_SceneState == SceneState::Play)
@@ -713,6 +788,7 @@ namespace phx
 			cam.AddComponent<CameraComponent>();
 		}
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
+		DiscardPicks();
 
 		m_EditorScenePath = std::filesystem::path();
 	}
@@ -771,6 +847,7 @@ namespace phx
 			m_EditorScene = newScene;
 			m_EditorScene->OnViewportResize((uint32_t)m_ViewportSize.x, (uint32_t)m_ViewportSize.y);
 			m_SceneHierarchyPanel.SetContext(m_EditorScene);
+			DiscardPicks();
 
 			m_ActiveScene = m_EditorScene;
 			m_EditorScenePath = path;
@@ -787,6 +864,7 @@ namespace phx
 		m_ActiveScene->OnRuntimeStart();
 
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
+		DiscardPicks();
 	}
 	void EditorLayer::OnScenePlayTest()
 	{
@@ -797,6 +875,7 @@ namespace phx
 		m_ActiveScene->OnRuntimeStart();
 
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
+		DiscardPicks();
 	}
 	void EditorLayer::OnSceneStop()
 	{
@@ -804,8 +883,10 @@ namespace phx
 
 		m_ActiveScene->OnRuntimeStop();
 		m_ActiveScene = m_EditorScene;
+		MeshCache::Collect();
 
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
+		DiscardPicks();
 	}
 
 	void EditorLayer::OnDuplicateEntity()
@@ -9,6 +9,7 @@
 #include "Panels/ShaderEditorPanel.h"
 
 #include <string>
+#include <deque>
 
 #include "Phoenix/Renderer/Mesh.h"
 
@@ -28,6 +29,8 @@ namespace phx {
 		bool OnKeyPressed(KeyPressedEvent& e);
 		bool OnMouseButtonPressed(MouseButtonPressedEvent& e);
 
+		void DiscardPicks();
+
 		void OnOverlayRender();
 
 		void NewScene(Scene::SceneType type, bool AddCamera = false);
@@ -61,6 +64,17 @@ namespace phx {
 
 		Entity m_HoveredEntity;
 
+		// Entity ID reads in flight, oldest first. A pick is only requested when the mouse moved or a click waits
+		// for its result, and the click selects whatever that read returns
+		struct PickRequest
+		{
+			Ref<Scene> Scene;
+			bool Select;
+		};
+		std::deque<PickRequest> m_PickRequests;
+		glm::ivec2 m_LastPickPosition = { -1, -1 };
+		bool m_SelectionPickPending = false;
+
 		bool m_PrimaryCamera = true;
 
 		EditorCamera m_EditorCamera;
@@ -196,6 +196,10 @@ namespace phx {
 		if (m_SelectionContext)
 		{
 			DrawComponents(m_SelectionContext);
+
+			// The properties edit components in place
+			if (m_SelectionContext)
+				m_Context->MarkRenderableDirty(m_SelectionContext);
 		}
 		ImGui::End();
 	}
@@ -353,6 +357,22 @@ namespace phx {
 							ImGui::CloseCurrentPopup();
 						}
 					}
+					if (!m_SelectionContext.HasComponent<TilemapComponent>())
+					{
+						if (ImGui::MenuItem("Tilemap"))
+						{
+							m_SelectionContext.AddComponent<TilemapComponent>();
+							ImGui::CloseCurrentPopup();
+						}
+					}
+					if (!m_SelectionContext.HasComponent<ParticleEmitterComponent>())
+					{
+						if (ImGui::MenuItem("Particle Emitter"))
+						{
+							m_SelectionContext.AddComponent<ParticleEmitterComponent>();
+							ImGui::CloseCurrentPopup();
+						}
+					}
 					ImGui::EndMenu();
 				}
 				if (ImGui::BeginMenu("Physics"))
@@ -544,6 +564,8 @@ namespace phx {
 					UI::DrawGap();
 
 					UI::DrawDragFloat("Tiling Factor", &component.TilingFactor, 0.1f);
+					UI::DrawDragInt("Sorting Layer", &component.SortingLayer, 0.1f, 0, 255);
+					UI::DrawCheckbox("Static", &component.Static);
 			});
 		}
 		if (entity.HasComponent<CircleRendererComponent>())
@@ -556,6 +578,115 @@ namespace phx {
 					float fade = component.Fade * 1000;
 					UI::DrawDragFloat("Fade", &fade, 2.0f, 0.0f, 100.0f);
 					component.Fade = fade / 1000;
+					UI::DrawDragInt("Sorting Layer", &component.SortingLayer, 0.1f, 0, 255);
+				});
+		}
+		if (entity.HasComponent<TilemapComponent>())
+		{
+			DrawComponent<TilemapComponent>("Tilemap", entity, [](auto& component)
+				{
+					UI::DrawColorControls("Color", component.Color);
+
+					ImGui::Columns(2);
+					ImGui::SetColumnWidth(0, 100.0f);
+					ImGui::Text("Atlas");
+					ImGui::NextColumn();
+					if (!component.Path.empty())
+						ImGui::Button(component.Path.c_str(), ImVec2(ImGui::GetContentRegionAvail().x, 25));
+					else
+						ImGui::Button("Drag Image", ImVec2(ImGui::GetContentRegionAvail().x, 25));
+
+					if (ImGui::BeginDragDropTarget())
+					{
+						if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("CONTENT_BROWSER_ITEM"))
+						{
+							const wchar_t* path = (const wchar_t*)payload->Data;
+							std::filesystem::path texturePath = std::filesystem::path(s_AssetPath) / path;
+							Ref<Texture2D> texture = Texture2D::Create(texturePath.string());
+							if (texture->IsLoaded())
+							{
+								component.Atlas = texture;
+								component.Path = texturePath.string();
+							}
+							else
+								PHX_CORE_WARN("Could not load texture {0}", texturePath.filename().string());
+						}
+
+						ImGui::EndDragDropTarget();
+					}
+					ImGui::Columns(1);
+
+					UI::DrawGap();
+
+					UI::DrawDragInt("Atlas Columns", &component.AtlasColumns, 0.1f, 1, 256);
+					UI::DrawDragInt("Atlas Rows", &component.AtlasRows, 0.1f, 1, 256);
+					UI::DrawVec2Controls("Tile Size", component.TileSize, 1.0f);
+
+					int width = (int)component.GetWidth();
+					int height = (int)component.GetHeight();
+					bool resized = UI::DrawDragInt("Width", &width, 1.0f, 0, 4096);
+					resized |= UI::DrawDragInt("Height", &height, 1.0f, 0, 4096);
+					if (resized)
+						component.Resize((uint32_t)std::max(width, 0), (uint32_t)std::max(height, 0));
+				});
+		}
+		if (entity.HasComponent<ParticleEmitterComponent>())
+		{
+			DrawComponent<ParticleEmitterComponent>("Particle Emitter", entity, [](auto& component)
+				{
+					UI::DrawCheckbox("Emitting", &component.Emitting);
+					UI::DrawDragFloat("Rate", &component.EmissionRate, 1.0f, 0.0f, 1000000.0f);
+					int maxParticles = (int)component.MaxParticles;
+					if (UI::DrawDragInt("Max Particles", &maxParticles, 100.0f, 0, 2000000))
+						component.MaxParticles = (uint32_t)std::max(maxParticles, 0);
+					UI::DrawDragInt("Sorting Layer", &component.SortingLayer, 0.1f, 0, 255);
+
+					UI::DrawGap();
+
+					UI::DrawDragFloat("Lifetime", &component.Lifetime, 0.01f, 0.0f, 100.0f);
+					UI::DrawDragFloat("Lifetime Var", &component.LifetimeVariation, 0.01f, 0.0f, 100.0f);
+					UI::DrawVec2Controls("Velocity", component.Velocity);
+					UI::DrawVec2Controls("Velocity Var", component.VelocityVariation);
+					UI::DrawDragFloat("Spin", &component.AngularVelocity, 0.1f);
+					UI::DrawDragFloat("Spin Var", &component.AngularVelocityVariation, 0.1f, 0.0f, 100.0f);
+					UI::DrawVec2Controls("Gravity", component.Update.Gravity);
+					UI::DrawDragFloat("Drag", &component.Update.Drag, 0.01f, 0.0f, 100.0f);
+
+					UI::DrawGap();
+
+					UI::DrawColorControls("Color Begin", component.Update.ColorBegin);
+					UI::DrawColorControls("Color End", component.Update.ColorEnd);
+					UI::DrawDragFloat("Size Begin", &component.Update.SizeBegin, 0.01f, 0.0f, 100.0f);
+					UI::DrawDragFloat("Size End", &component.Update.SizeEnd, 0.01f, 0.0f, 100.0f);
+
+					ImGui::Columns(2);
+					ImGui::SetColumnWidth(0, 100.0f);
+					ImGui::Text("Texture");
+					ImGui::NextColumn();
+					if (!component.Path.empty())
+						ImGui::Button(component.Path.c_str(), ImVec2(ImGui::GetContentRegionAvail().x, 25));
+					else
+						ImGui::Button("Drag Image", ImVec2(ImGui::GetContentRegionAvail().x, 25));
+
+					if (ImGui::BeginDragDropTarget())
+					{
+						if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("CONTENT_BROWSER_ITEM"))
+						{
+							const wchar_t* path = (const wchar_t*)payload->Data;
+							std::filesystem::path texturePath = std::filesystem::path(s_AssetPath) / path;
+							Ref<Texture2D> texture = Texture2D::Create(texturePath.string());
+							if (texture->IsLoaded())
+							{
+								component.Texture = texture;
+								component.Path = texturePath.string();
+							}
+							else
+								PHX_CORE_WARN("Could not load texture {0}", texturePath.filename().string());
+						}
+
+						ImGui::EndDragDropTarget();
+					}
+					ImGui::Columns(1);
 				});
 		}
 		if (entity.HasComponent<Rigidbody2DComponent>())
@@ -652,13 +783,16 @@ namespace phx {
 							const wchar_t* path = (const wchar_t*)payload->Data;
 							std::filesystem::path filepath = std::filesystem::path(s_AssetPath) / path;
 
-							component.Mesh = Mesh(filepath.string());
+							component.Mesh = MeshCache::Load(filepath.string());
 							component.Path = filepath.string();
 						}
 
 						ImGui::EndDragDropTarget();
 					}
 					ImGui::Columns(1);
+
+					UI::DrawCheckbox("Static", &component.Static);
+					UI::DrawCheckbox("Occluder", &component.Occluder);
 				});
 		}
 	}
@@ -1,11 +1,15 @@
 #version 450 core
 
-layout(location = 0) in vec3 a_WorldPosition;
-layout(location = 1) in vec3 a_LocalPosition;
-layout(location = 2) in vec4 a_Color;
-layout(location = 3) in float a_Thickness;
-layout(location = 4) in float a_Fade;
-layout(location = 5) in int a_EntityID;
+// Per-vertex: corner of the unit quad
+layout(location = 0) in vec2 a_Position;
+
+// Per-instance
+layout(location = 1) in vec3 a_Right;
+layout(location = 2) in vec3 a_Up;
+layout(location = 3) in vec3 a_Origin;
+layout(location = 4) in vec4 a_Color;         // RGBA8
+layout(location = 5) in vec2 a_ThicknessFade; // Half floats
+layout(location = 6) in int a_EntityID;       // Absent in Dist builds
 
 layout(std140, binding = 0) uniform Camera
 {
@@ -25,12 +29,13 @@ layout (location = 4) out flat int v_EntityID;
 
 void main()
 {
-	Output.LocalPosition = a_LocalPosition;
+	Output.LocalPosition = vec3(a_Position * 2.0, 0.0);
 	Output.Color = a_Color;
-	Output.Thickness = a_Thickness;
-	Output.Fade = a_Fade;
+	Output.Thickness = a_ThicknessFade.x;
+	Output.Fade = a_ThicknessFade.y;
 
 	v_EntityID = a_EntityID;
 
-	gl_Position = u_ViewProjection * vec4(a_WorldPosition, 1.0);
+	vec3 worldPosition = a_Origin + a_Right * a_Position.x + a_Up * a_Position.y;
+	gl_Position = u_ViewProjection * vec4(worldPosition, 1.0);
 }
@@ -14,8 +14,11 @@ struct VertexOutput
 layout (location = 0) in VertexOutput Input;
 layout (location = 3) in flat float v_TexIndex;
 layout (location = 4) in flat int v_EntityID;
+layout (location = 5) in flat float v_TexLayer;
 
-layout (binding = 0) uniform sampler2D u_Textures[32];
+// Indices 0-23 are plain textures, 24-31 select a texture array and sample layer v_TexLayer
+layout (binding = 0) uniform sampler2D u_Textures[24];
+layout (binding = 24) uniform sampler2DArray u_TextureArrays[8];
 
 void main()
 {
@@ -47,14 +50,14 @@ void main()
 		case 21: texColor *= texture(u_Textures[21], Input.TexCoord * Input.TilingFactor); break;
 		case 22: texColor *= texture(u_Textures[22], Input.TexCoord * Input.TilingFactor); break;
 		case 23: texColor *= texture(u_Textures[23], Input.TexCoord * Input.TilingFactor); break;
-		case 24: texColor *= texture(u_Textures[24], Input.TexCoord * Input.TilingFactor); break;
-		case 25: texColor *= texture(u_Textures[25], Input.TexCoord * Input.TilingFactor); break;
-		case 26: texColor *= texture(u_Textures[26], Input.TexCoord * Input.TilingFactor); break;
-		case 27: texColor *= texture(u_Textures[27], Input.TexCoord * Input.TilingFactor); break;
-		case 28: texColor *= texture(u_Textures[28], Input.TexCoord * Input.TilingFactor); break;
-		case 29: texColor *= texture(u_Textures[29], Input.TexCoord * Input.TilingFactor); break;
-		case 30: texColor *= texture(u_Textures[30], Input.TexCoord * Input.TilingFactor); break;
-		case 31: texColor *= texture(u_Textures[31], Input.TexCoord * Input.TilingFactor); break;
+		case 24: texColor *= texture(u_TextureArrays[0], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 25: texColor *= texture(u_TextureArrays[1], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 26: texColor *= texture(u_TextureArrays[2], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 27: texColor *= texture(u_TextureArrays[3], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 28: texColor *= texture(u_TextureArrays[4], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 29: texColor *= texture(u_TextureArrays[5], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 30: texColor *= texture(u_TextureArrays[6], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 31: texColor *= texture(u_TextureArrays[7], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
 	}
 	o_Color = texColor;
 
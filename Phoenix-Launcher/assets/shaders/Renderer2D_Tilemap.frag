@@ -0,0 +1,41 @@
+// Renderer 2D Tilemap Shader
+#version 450 core
+
+layout(location = 0) out vec4 o_Color;
+layout(location = 1) out int o_EntityID;
+
+layout (location = 0) in vec2 v_ChunkCoord;
+
+layout(std140, binding = 1) uniform Tilemap
+{
+	mat4 u_ChunkTransform;
+	vec4 u_Color;
+	ivec2 u_AtlasGrid;
+	int u_ChunkSize;
+	int u_EntityID;
+};
+
+layout (binding = 0) uniform usampler2D u_TileIndices;
+layout (binding = 1) uniform sampler2D u_Atlas;
+
+void main()
+{
+	vec2 tileCoord = v_ChunkCoord * float(u_ChunkSize);
+	ivec2 tile = min(ivec2(tileCoord), ivec2(u_ChunkSize - 1));
+	uint index = texelFetch(u_TileIndices, tile, 0).r;
+	if (index == 0u)
+		discard;
+
+	// Cells count from the top-left of the atlas. Stay half a texel inside the cell so neighbours do not bleed in
+	int cell = int(index) - 1;
+	vec2 cellOrigin = vec2(cell % u_AtlasGrid.x, u_AtlasGrid.y - 1 - cell / u_AtlasGrid.x);
+	vec2 cellTexels = vec2(textureSize(u_Atlas, 0)) / vec2(u_AtlasGrid);
+	vec2 cellCoord = clamp(fract(tileCoord), 0.5 / cellTexels, 1.0 - 0.5 / cellTexels);
+
+	vec4 color = texture(u_Atlas, (cellOrigin + cellCoord) / vec2(u_AtlasGrid)) * u_Color;
+	if (color.a == 0.0)
+		discard;
+
+	o_Color = color;
+	o_EntityID = u_EntityID;
+}
@@ -0,0 +1,27 @@
+// Renderer 2D Tilemap Shader
+#version 450 core
+
+// Corner of the unit quad
+layout(location = 0) in vec2 a_Position;
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjection;
+};
+
+layout(std140, binding = 1) uniform Tilemap
+{
+	mat4 u_ChunkTransform;
+	vec4 u_Color;
+	ivec2 u_AtlasGrid;
+	int u_ChunkSize;
+	int u_EntityID;
+};
+
+layout (location = 0) out vec2 v_ChunkCoord; // 0-1 across the chunk
+
+void main()
+{
+	v_ChunkCoord = a_Position + 0.5;
+	gl_Position = u_ViewProjection * u_ChunkTransform * vec4(a_Position, 0.0, 1.0);
+}
@@ -1,13 +1,21 @@
 #version 450
 
 layout(location = 0) in vec3 a_Position;
+layout(location = 6) in int a_ObjectIndex; // Per-instance, set through the base instance
 
-layout(std140, binding = 0) uniform Camera
+layout(std140, binding = 2) uniform Camera
 {
 	mat4 u_ViewProjection;
 };
 
+// Renderer3D::MaxObjectsPerBatch objects
+layout(std140, binding = 3) uniform Objects
+{
+	mat4 u_Transforms[128];
+	ivec4 u_EntityIDs[32];
+};
+
 void main()
 {
-	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+	gl_Position = u_ViewProjection * u_Transforms[a_ObjectIndex] * vec4(a_Position, 1.0);
 }
\ No newline at end of file
@@ -49,13 +49,17 @@
 //---------------Renderer-----------------
 #include "Phoenix/Renderer/Renderer.h"
 #include "Phoenix/Renderer/Renderer2D.h"
+#include "Phoenix/Renderer/Renderer3D.h"
 #include "Phoenix/Renderer/RenderCommand.h"
+#include "Phoenix/Renderer/RenderCommandBuffer.h"
+#include "Phoenix/Renderer/GPUProfiler.h"
 #include "Phoenix/Renderer/Buffer.h"
 #include "Phoenix/Renderer/Shader.h"
 #include "Phoenix/Renderer/VertexArray.h"
 #include "Phoenix/Renderer/OrthographicCamera.h"
 #include "Phoenix/Renderer/OrthographicCameraController.h"
 #include "Phoenix/Renderer/Texture.h"
+#include "Phoenix/Renderer/MeshCache.h"
 #include "Phoenix/Renderer/Framebuffer.h"
 //----------------------------------------
 
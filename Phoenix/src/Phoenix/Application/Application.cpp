@@ -3,7 +3,10 @@
 
 #include "Phoenix/Input/Input.h"
 #include "Phoenix/Renderer/Buffer.h"
+#include "Phoenix/Renderer/RenderCommandBuffer.h"
+#include "Phoenix/Renderer/GPUProfiler.h"
 #include "Phoenix/Renderer/Renderer.h"
+#include "Phoenix/Threading/JobSystem.h"
 
 #include <GLFW/glfw3.h>
 
@@ -25,6 +28,8 @@ namespace phx {
 		m_Window = Window::Create(WindowProps(spec.Name, spec.WindowWidth, spec.WindowHeight, spec.WindowDecorated));
 		m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
 
+		JobSystem::Init();
+
 		if(spec.InitRenderer)
 			Renderer::Init();
 
@@ -35,6 +40,9 @@ namespace phx {
 	Application::~Application()
 	{
 		PHX_PROFILE_FUNCTION();
+
+		GPUProfiler::Shutdown();
+		JobSystem::Shutdown();
 	}
 
 	void Application::PushLayer(Layer* layer)
@@ -80,12 +88,18 @@ namespace phx {
 			float time = (float)glfwGetTime();
 			DeltaTime deltaTime = time - m_DeltaTime;
 			m_DeltaTime = time;
+
+			GPUProfiler::BeginFrame();
 			if (!m_Minimized)
 			{
 				PHX_PROFILE_SCOPE("LayerStack OnUpdate");
 				for (Layer* layer : m_LayerStack)
 					layer->OnUpdate(deltaTime);
 			}		
+			// Buffers recorded during the update and not flushed yet, on this thread or by jobs, replay before the
+			// UI draws over them
+			RenderCommandQueue::Flush();
+
 			m_ImGuiLayer->Begin();
 			{
 				PHX_PROFILE_SCOPE("LayerStack OnImGuiRender");
@@ -93,7 +107,10 @@ namespace phx {
 				for (Layer* layer : m_LayerStack)
 					layer->OnImGuiRender();
 			}			
-			m_ImGuiLayer->End();
+			{
+				GPUProfileScope gpuScope("ImGui");
+				m_ImGuiLayer->End();
+			}
 
 			m_Window->OnUpdate();
 		}
@@ -7,6 +7,12 @@
 #ifdef PHX_DEBUG
 #define PHX_ENABLE_ASSERTS
 #endif
+// Renderers write entity IDs next to color so the editor can pick entities. Dist builds drop them from
+// vertex data and framebuffers
+#ifndef PHX_DIST_MODE
+	#define PHX_RENDERER_ENTITY_ID
+#endif
+
 #ifdef PHX_ENABLE_ASSERTS
 	#define PHX_ASSERT(x, ...) { if(!(x)) { PHX_ERROR("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); } }
 	#define PHX_CORE_ASSERT(x, ...) { if(!(x)) { PHX_CORE_ERROR("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); } }
@@ -95,6 +95,30 @@ namespace phx {
 			}
 		}
 
+		// GPU passes go to their own process in the trace, since they overlap the CPU work that issued them
+		void WriteGPUProfile(const ProfileResult& result)
+		{
+			std::stringstream json;
+
+			json << std::setprecision(3) << std::fixed;
+			json << ",{";
+			json << "\"cat\":\"gpu\",";
+			json << "\"dur\":" << (result.ElapsedTime.count()) << ',';
+			json << "\"name\":\"" << result.Name << "\",";
+			json << "\"ph\":\"X\",";
+			json << "\"pid\":1,";
+			json << "\"tid\":0,";
+			json << "\"ts\":" << result.Start.count();
+			json << "}";
+
+			std::lock_guard lock(m_Mutex);
+			if (m_CurrentSession)
+			{
+				m_OutputStream << json.str();
+				m_OutputStream.flush();
+			}
+		}
+
 		static Instrumentor& Get()
 		{
 			static Instrumentor instance;
@@ -114,6 +138,7 @@ namespace phx {
 		void WriteHeader()
 		{
 			m_OutputStream << "{\"otherData\": {},\"traceEvents\":[{}";
+			m_OutputStream << ",{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}}";
 			m_OutputStream.flush();
 		}
 
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace phx::Math {
+
+	struct AABB
+	{
+		glm::vec3 Min{ 0.0f };
+		glm::vec3 Max{ 0.0f };
+
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetHalfExtent() const { return (Max - Min) * 0.5f; }
+
+		void Grow(const AABB& other)
+		{
+			Min = glm::min(Min, other.Min);
+			Max = glm::max(Max, other.Max);
+		}
+
+		bool Intersects(const AABB& other) const
+		{
+			return Min.x <= other.Max.x && Max.x >= other.Min.x
+				&& Min.y <= other.Max.y && Max.y >= other.Min.y
+				&& Min.z <= other.Max.z && Max.z >= other.Min.z;
+		}
+
+		// Box around the transformed box, which can be looser than the box around the transformed contents
+		AABB Transform(const glm::mat4& transform) const
+		{
+			glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+			glm::vec3 halfExtent = GetHalfExtent();
+			glm::vec3 extent = glm::abs(glm::vec3(transform[0])) * halfExtent.x
+				+ glm::abs(glm::vec3(transform[1])) * halfExtent.y
+				+ glm::abs(glm::vec3(transform[2])) * halfExtent.z;
+			return { center - extent, center + extent };
+		}
+	};
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace phx::Math {
+
+	struct AABB2D
+	{
+		glm::vec2 Min{ 0.0f };
+		glm::vec2 Max{ 0.0f };
+
+		glm::vec2 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec2 GetHalfExtent() const { return (Max - Min) * 0.5f; }
+
+		bool Intersects(const AABB2D& other) const
+		{
+			return Min.x <= other.Max.x && Max.x >= other.Min.x
+				&& Min.y <= other.Max.y && Max.y >= other.Min.y;
+		}
+	};
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Phoenix/Math/AABB.h"
+
+#include <glm/glm.hpp>
+
+namespace phx::Math {
+
+	// The six planes of a view-projection matrix, normals pointing inwards. Tests are conservative: boxes near
+	// a corner of the frustum can pass while being outside it
+	struct Frustum
+	{
+		enum class Result { Outside = 0, Intersecting, Inside };
+
+		glm::vec4 Planes[6]; // xyz = normal, w = distance, so a point p is inside when dot(xyz, p) + w >= 0
+
+		static Frustum FromViewProjection(const glm::mat4& viewProjection)
+		{
+			glm::vec4 rows[4];
+			for (int i = 0; i < 4; i++)
+				rows[i] = { viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i] };
+
+			Frustum frustum;
+			frustum.Planes[0] = rows[3] + rows[0]; // Left
+			frustum.Planes[1] = rows[3] - rows[0]; // Right
+			frustum.Planes[2] = rows[3] + rows[1]; // Bottom
+			frustum.Planes[3] = rows[3] - rows[1]; // Top
+			frustum.Planes[4] = rows[3] + rows[2]; // Near
+			frustum.Planes[5] = rows[3] - rows[2]; // Far
+			for (glm::vec4& plane : frustum.Planes)
+				plane /= glm::length(glm::vec3(plane));
+			return frustum;
+		}
+
+		Result Classify(const AABB& box) const
+		{
+			glm::vec3 center = box.GetCenter();
+			glm::vec3 halfExtent = box.GetHalfExtent();
+
+			Result result = Result::Inside;
+			for (const glm::vec4& plane : Planes)
+			{
+				glm::vec3 normal = glm::vec3(plane);
+				float distance = glm::dot(normal, center) + plane.w;
+				float radius = glm::dot(halfExtent, glm::abs(normal));
+				if (distance + radius < 0.0f)
+					return Result::Outside;
+				if (distance - radius < 0.0f)
+					result = Result::Intersecting;
+			}
+			return result;
+		}
+
+		bool Intersects(const AABB& box) const { return Classify(box) != Result::Outside; }
+	};
+
+}
@@ -0,0 +1,148 @@
+#include "phxpch.h"
+#include "QuadTransforms.h"
+
+#include "Phoenix/Math/SIMDLanes.h"
+
+namespace phx::Math {
+
+	static constexpr uint32_t BlockSize = 8;
+
+	// One block of sprites transposed to structure-of-arrays form
+	struct alignas(32) TransformBlock
+	{
+		float Translation[3][BlockSize];
+		float Rotation[3][BlockSize];
+		float Scale[3][BlockSize];
+
+		float Right[3][BlockSize];
+		float Up[3][BlockSize];
+	};
+
+	// Rotation about z only: Right = R * (sx, 0, 0), Up = R * (0, sy, 0)
+	template<typename L>
+	static void ComputeBlock2D(TransformBlock& block)
+	{
+		using V = typename L::Type;
+		for (uint32_t i = 0; i < BlockSize; i += L::Width)
+		{
+			V sinZ, cosZ;
+			L::SinCos(L::Load(&block.Rotation[2][i]), sinZ, cosZ);
+
+			V scaleX = L::Load(&block.Scale[0][i]);
+			V scaleY = L::Load(&block.Scale[1][i]);
+
+			L::Store(&block.Right[0][i], L::Mul(cosZ, scaleX));
+			L::Store(&block.Right[1][i], L::Mul(sinZ, scaleX));
+			L::Store(&block.Right[2][i], L::Set(0.0f));
+
+			L::Store(&block.Up[0][i], L::Sub(L::Set(0.0f), L::Mul(sinZ, scaleY)));
+			L::Store(&block.Up[1][i], L::Mul(cosZ, scaleY));
+			L::Store(&block.Up[2][i], L::Set(0.0f));
+		}
+	}
+
+	// Full XYZ Euler rotation, built the same way as glm::quat(euler) followed by glm::toMat4
+	template<typename L>
+	static void ComputeBlock3D(TransformBlock& block)
+	{
+		using V = typename L::Type;
+		const V half = L::Set(0.5f);
+		const V one = L::Set(1.0f);
+		const V two = L::Set(2.0f);
+
+		for (uint32_t i = 0; i < BlockSize; i += L::Width)
+		{
+			V sx, cx, sy, cy, sz, cz;
+			L::SinCos(L::Mul(L::Load(&block.Rotation[0][i]), half), sx, cx);
+			L::SinCos(L::Mul(L::Load(&block.Rotation[1][i]), half), sy, cy);
+			L::SinCos(L::Mul(L::Load(&block.Rotation[2][i]), half), sz, cz);
+
+			V cycz = L::Mul(cy, cz), sysz = L::Mul(sy, sz);
+			V sycz = L::Mul(sy, cz), cysz = L::Mul(cy, sz);
+			V qw = L::Add(L::Mul(cx, cycz), L::Mul(sx, sysz));
+			V qx = L::Sub(L::Mul(sx, cycz), L::Mul(cx, sysz));
+			V qy = L::Add(L::Mul(cx, sycz), L::Mul(sx, cysz));
+			V qz = L::Sub(L::Mul(cx, cysz), L::Mul(sx, sycz));
+
+			V xx = L::Mul(qx, qx), yy = L::Mul(qy, qy), zz = L::Mul(qz, qz);
+			V xy = L::Mul(qx, qy), xz = L::Mul(qx, qz), yz = L::Mul(qy, qz);
+			V wx = L::Mul(qw, qx), wy = L::Mul(qw, qy), wz = L::Mul(qw, qz);
+
+			V scaleX = L::Load(&block.Scale[0][i]);
+			V scaleY = L::Load(&block.Scale[1][i]);
+
+			L::Store(&block.Right[0][i], L::Mul(L::Sub(one, L::Mul(two, L::Add(yy, zz))), scaleX));
+			L::Store(&block.Right[1][i], L::Mul(L::Mul(two, L::Add(xy, wz)), scaleX));
+			L::Store(&block.Right[2][i], L::Mul(L::Mul(two, L::Sub(xz, wy)), scaleX));
+
+			L::Store(&block.Up[0][i], L::Mul(L::Mul(two, L::Sub(xy, wz)), scaleY));
+			L::Store(&block.Up[1][i], L::Mul(L::Sub(one, L::Mul(two, L::Add(xx, zz))), scaleY));
+			L::Store(&block.Up[2][i], L::Mul(L::Mul(two, L::Add(yz, wx)), scaleY));
+		}
+	}
+
+	void ComputeQuadAxes(const glm::vec3* translations, const glm::vec3* rotations, const glm::vec3* scales, uint32_t count, QuadAxes* outAxes)
+	{
+		TransformBlock block;
+
+		for (uint32_t blockBegin = 0; blockBegin < count; blockBegin += BlockSize)
+		{
+			uint32_t blockCount = std::min(BlockSize, count - blockBegin);
+
+			// Transpose into the block, padding a partial block with identity transforms
+			bool is2D = true;
+			for (uint32_t i = 0; i < BlockSize; i++)
+			{
+				bool valid = i < blockCount;
+				const glm::vec3 translation = valid ? translations[blockBegin + i] : glm::vec3(0.0f);
+				const glm::vec3 rotation = valid ? rotations[blockBegin + i] : glm::vec3(0.0f);
+				const glm::vec3 scale = valid ? scales[blockBegin + i] : glm::vec3(1.0f);
+
+				for (uint32_t axis = 0; axis < 3; axis++)
+				{
+					block.Translation[axis][i] = translation[axis];
+					block.Rotation[axis][i] = rotation[axis];
+					block.Scale[axis][i] = scale[axis];
+				}
+
+				is2D &= rotation.x == 0.0f && rotation.y == 0.0f;
+			}
+
+			if (is2D)
+				ComputeBlock2D<SIMDLanes>(block);
+			else
+				ComputeBlock3D<SIMDLanes>(block);
+
+			for (uint32_t i = 0; i < blockCount; i++)
+			{
+				QuadAxes& axes = outAxes[blockBegin + i];
+				axes.Right = { block.Right[0][i], block.Right[1][i], block.Right[2][i] };
+				axes.Up = { block.Up[0][i], block.Up[1][i], block.Up[2][i] };
+				axes.Origin = { block.Translation[0][i], block.Translation[1][i], block.Translation[2][i] };
+			}
+		}
+	}
+
+	void ComputeQuadCorners(const QuadAxes* axes, uint32_t count, glm::vec3 (*outCorners)[4])
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			glm::vec3 halfRight = axes[i].Right * 0.5f;
+			glm::vec3 halfUp = axes[i].Up * 0.5f;
+
+			outCorners[i][0] = axes[i].Origin - halfRight - halfUp;
+			outCorners[i][1] = axes[i].Origin + halfRight - halfUp;
+			outCorners[i][2] = axes[i].Origin + halfRight + halfUp;
+			outCorners[i][3] = axes[i].Origin - halfRight + halfUp;
+		}
+	}
+
+	AABB2D ComputeQuadBounds(const QuadAxes& axes)
+	{
+		glm::vec2 halfExtent = (glm::abs(glm::vec2(axes.Right)) + glm::abs(glm::vec2(axes.Up))) * 0.5f;
+		glm::vec2 center = glm::vec2(axes.Origin);
+
+		return { center - halfExtent, center + halfExtent };
+	}
+
+}
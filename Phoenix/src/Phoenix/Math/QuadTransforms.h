@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Phoenix/Math/AABB2D.h"
+
+#include <glm/glm.hpp>
+
+namespace phx::Math {
+
+	// Axes of a unit quad after a transform: the quad point (x, y) lands at Origin + x * Right + y * Up
+	struct QuadAxes
+	{
+		glm::vec3 Right;
+		glm::vec3 Up;
+		glm::vec3 Origin;
+	};
+
+	// Batch equivalent of applying TransformComponent::GetTransform to a unit quad. Rotations are XYZ Euler angles
+	// in radians. Works through blocks of 8 with AVX2 or SSE2 when the build targets them, and blocks whose
+	// rotations are all about z take a cheaper 2D path
+	void ComputeQuadAxes(const glm::vec3* translations, const glm::vec3* rotations, const glm::vec3* scales, uint32_t count, QuadAxes* outAxes);
+
+	// Corners in Renderer2D's unit quad order: (-0.5, -0.5), (0.5, -0.5), (0.5, 0.5), (-0.5, 0.5)
+	void ComputeQuadCorners(const QuadAxes* axes, uint32_t count, glm::vec3 (*outCorners)[4]);
+
+	// XY bounds of the transformed unit quad
+	AABB2D ComputeQuadBounds(const QuadAxes& axes);
+
+}
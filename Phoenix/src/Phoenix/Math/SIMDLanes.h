@@ -0,0 +1,185 @@
+#pragma once
+
+// Internal to the engine's SIMD kernels, include from .cpp files only
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define PHX_SIMD_AVX2
+#elif defined(_M_X64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define PHX_SIMD_SSE2
+#endif
+
+namespace phx::Math {
+
+	// Each lane type wraps one instruction set behind the same handful of operations so kernels are written
+	// once as templates over the lane type. Width is the number of floats per register. Load and Store need
+	// Width * 4 byte alignment, the Unaligned variants do not
+
+	struct ScalarLanes
+	{
+		using Type = float;
+		static constexpr uint32_t Width = 1;
+
+		static Type Load(const float* p) { return *p; }
+		static void Store(float* p, Type v) { *p = v; }
+		static Type LoadUnaligned(const float* p) { return *p; }
+		static void StoreUnaligned(float* p, Type v) { *p = v; }
+		static Type Set(float v) { return v; }
+		static Type Add(Type a, Type b) { return a + b; }
+		static Type Sub(Type a, Type b) { return a - b; }
+		static Type Mul(Type a, Type b) { return a * b; }
+		static Type Min(Type a, Type b) { return a < b ? a : b; }
+		static Type Max(Type a, Type b) { return a > b ? a : b; }
+		// Per lane a >= b ? ifTrue : ifFalse
+		static Type SelectGE(Type a, Type b, Type ifTrue, Type ifFalse) { return a >= b ? ifTrue : ifFalse; }
+
+		// Like glm::packUnorm4x8, but inputs must already be in [0, 1]. Ties may round either way per lane type
+		static void StoreUnorm4x8(uint32_t* p, Type r, Type g, Type b, Type a)
+		{
+			*p = (uint32_t)(r * 255.0f + 0.5f) | (uint32_t)(g * 255.0f + 0.5f) << 8
+				| (uint32_t)(b * 255.0f + 0.5f) << 16 | (uint32_t)(a * 255.0f + 0.5f) << 24;
+		}
+
+		static void SinCos(Type v, Type& outSin, Type& outCos)
+		{
+			outSin = std::sin(v);
+			outCos = std::cos(v);
+		}
+	};
+
+	// Cody-Waite split of pi/2 and minimax polynomials for sin/cos on [-pi/4, pi/4]
+	static constexpr float TwoOverPi = 0.636619772f;
+	static constexpr float PiOver2A = 1.5703125f;
+	static constexpr float PiOver2B = 4.837512969970703125e-4f;
+	static constexpr float PiOver2C = 7.54978995489188216e-8f;
+	static constexpr float SinC1 = -1.6666654611e-1f, SinC2 = 8.3321608736e-3f, SinC3 = -1.9515295891e-4f;
+	static constexpr float CosC1 = 4.166664568298827e-2f, CosC2 = -1.388731625493765e-3f, CosC3 = 2.443315711809948e-5f;
+
+#if defined(PHX_SIMD_SSE2)
+	struct SIMDLanes
+	{
+		using Type = __m128;
+		static constexpr uint32_t Width = 4;
+
+		static Type Load(const float* p) { return _mm_load_ps(p); }
+		static void Store(float* p, Type v) { _mm_store_ps(p, v); }
+		static Type LoadUnaligned(const float* p) { return _mm_loadu_ps(p); }
+		static void StoreUnaligned(float* p, Type v) { _mm_storeu_ps(p, v); }
+		static Type Set(float v) { return _mm_set1_ps(v); }
+		static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+		static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+		static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+		static Type Min(Type a, Type b) { return _mm_min_ps(a, b); }
+		static Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+		static Type SelectGE(Type a, Type b, Type ifTrue, Type ifFalse)
+		{
+			__m128 mask = _mm_cmpge_ps(a, b);
+			return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+		}
+
+		static void StoreUnorm4x8(uint32_t* p, Type r, Type g, Type b, Type a)
+		{
+			const __m128 scale = _mm_set1_ps(255.0f);
+			__m128i packed = _mm_cvtps_epi32(_mm_mul_ps(r, scale));
+			packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(g, scale)), 8));
+			packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(b, scale)), 16));
+			packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)), 24));
+			_mm_storeu_si128((__m128i*)p, packed);
+		}
+
+		static void SinCos(Type v, Type& outSin, Type& outCos)
+		{
+			// Reduce to r in [-pi/4, pi/4] and quadrant q
+			__m128i q = _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(TwoOverPi)));
+			__m128 j = _mm_cvtepi32_ps(q);
+			__m128 r = _mm_sub_ps(v, _mm_mul_ps(j, _mm_set1_ps(PiOver2A)));
+			r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(PiOver2B)));
+			r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(PiOver2C)));
+
+			__m128 r2 = _mm_mul_ps(r, r);
+			__m128 sinPoly = _mm_add_ps(_mm_set1_ps(SinC2), _mm_mul_ps(r2, _mm_set1_ps(SinC3)));
+			sinPoly = _mm_add_ps(_mm_set1_ps(SinC1), _mm_mul_ps(r2, sinPoly));
+			sinPoly = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sinPoly));
+
+			__m128 cosPoly = _mm_add_ps(_mm_set1_ps(CosC2), _mm_mul_ps(r2, _mm_set1_ps(CosC3)));
+			cosPoly = _mm_add_ps(_mm_set1_ps(CosC1), _mm_mul_ps(r2, cosPoly));
+			cosPoly = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_mul_ps(_mm_mul_ps(r2, r2), cosPoly));
+
+			// Odd quadrants swap sin and cos, bit 1 of q (and of q + 1 for cos) flips the sign
+			const __m128i one = _mm_set1_epi32(1);
+			const __m128i two = _mm_set1_epi32(2);
+			__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+			__m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+			__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+
+			__m128 sinValue = _mm_or_ps(_mm_and_ps(swap, cosPoly), _mm_andnot_ps(swap, sinPoly));
+			__m128 cosValue = _mm_or_ps(_mm_and_ps(swap, sinPoly), _mm_andnot_ps(swap, cosPoly));
+			outSin = _mm_xor_ps(sinValue, sinSign);
+			outCos = _mm_xor_ps(cosValue, cosSign);
+		}
+	};
+#elif defined(PHX_SIMD_AVX2)
+	struct SIMDLanes
+	{
+		using Type = __m256;
+		static constexpr uint32_t Width = 8;
+
+		static Type Load(const float* p) { return _mm256_load_ps(p); }
+		static void Store(float* p, Type v) { _mm256_store_ps(p, v); }
+		static Type LoadUnaligned(const float* p) { return _mm256_loadu_ps(p); }
+		static void StoreUnaligned(float* p, Type v) { _mm256_storeu_ps(p, v); }
+		static Type Set(float v) { return _mm256_set1_ps(v); }
+		static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+		static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+		static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+		static Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+		static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+		static Type SelectGE(Type a, Type b, Type ifTrue, Type ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, _mm256_cmp_ps(a, b, _CMP_GE_OQ)); }
+
+		static void StoreUnorm4x8(uint32_t* p, Type r, Type g, Type b, Type a)
+		{
+			const __m256 scale = _mm256_set1_ps(255.0f);
+			__m256i packed = _mm256_cvtps_epi32(_mm256_mul_ps(r, scale));
+			packed = _mm256_or_si256(packed, _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(g, scale)), 8));
+			packed = _mm256_or_si256(packed, _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(b, scale)), 16));
+			packed = _mm256_or_si256(packed, _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(a, scale)), 24));
+			_mm256_storeu_si256((__m256i*)p, packed);
+		}
+
+		static void SinCos(Type v, Type& outSin, Type& outCos)
+		{
+			// Same reduction and polynomials as the SSE2 version, 8 wide
+			__m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(v, _mm256_set1_ps(TwoOverPi)));
+			__m256 j = _mm256_cvtepi32_ps(q);
+			__m256 r = _mm256_sub_ps(v, _mm256_mul_ps(j, _mm256_set1_ps(PiOver2A)));
+			r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(PiOver2B)));
+			r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(PiOver2C)));
+
+			__m256 r2 = _mm256_mul_ps(r, r);
+			__m256 sinPoly = _mm256_add_ps(_mm256_set1_ps(SinC2), _mm256_mul_ps(r2, _mm256_set1_ps(SinC3)));
+			sinPoly = _mm256_add_ps(_mm256_set1_ps(SinC1), _mm256_mul_ps(r2, sinPoly));
+			sinPoly = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), sinPoly));
+
+			__m256 cosPoly = _mm256_add_ps(_mm256_set1_ps(CosC2), _mm256_mul_ps(r2, _mm256_set1_ps(CosC3)));
+			cosPoly = _mm256_add_ps(_mm256_set1_ps(CosC1), _mm256_mul_ps(r2, cosPoly));
+			cosPoly = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(r2, _mm256_set1_ps(0.5f))), _mm256_mul_ps(_mm256_mul_ps(r2, r2), cosPoly));
+
+			const __m256i one = _mm256_set1_epi32(1);
+			const __m256i two = _mm256_set1_epi32(2);
+			__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+			__m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+			__m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+
+			outSin = _mm256_xor_ps(_mm256_blendv_ps(sinPoly, cosPoly, swap), sinSign);
+			outCos = _mm256_xor_ps(_mm256_blendv_ps(cosPoly, sinPoly, swap), cosSign);
+		}
+	};
+#else
+	using SIMDLanes = ScalarLanes;
+#endif
+
+}
@@ -31,6 +31,18 @@ namespace phx {
 		return nullptr;
 	}
 
+	Ref<StreamingVertexBuffer> StreamingVertexBuffer::Create(uint32_t regionSize, uint32_t regionCount)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:    PHX_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLStreamingVertexBuffer>(regionSize, regionCount);
+		}
+
+		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
 	Ref<IndexBuffer> IndexBuffer::Create(Indice* indices, uint32_t size)
 	{
 		switch (Renderer::GetAPI())
@@ -42,6 +54,17 @@ namespace phx {
 		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
+	Ref<IndexBuffer> IndexBuffer::Create(uint16_t* indices, uint32_t size)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:    PHX_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLIndexBuffer>(indices, size);
+		}
+
+		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
 	Ref<IndexBuffer> IndexBuffer::Create(uint32_t* indices, uint32_t size)
 	{
 		switch (Renderer::GetAPI())
@@ -53,4 +76,16 @@ namespace phx {
 		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
+
+	Ref<IndirectBuffer> IndirectBuffer::Create(uint32_t size)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:    PHX_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLIndirectBuffer>(size);
+		}
+
+		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
 }
\ No newline at end of file
@@ -9,7 +9,10 @@ namespace phx {
 
 	enum class ShaderDataType
 	{
-		None = 0, Float, vec2, vec3, vec4, mat3, mat4, Int, int2, int3, int4, Bool
+		None = 0, Float, vec2, vec3, vec4, mat3, mat4, Int, int2, int3, int4, Bool,
+
+		// Compact types. The integer ones read as [0, 1] floats when the element is normalized
+		ubyte4, ushort2, ushort4, half2
 	};
 
 	static uint32_t ShaderDataTypeSize(ShaderDataType type)
@@ -27,6 +30,10 @@ namespace phx {
 		case ShaderDataType::int3: return 4 * 3;
 		case ShaderDataType::int4: return 4 * 4;
 		case ShaderDataType::Bool: return 1;
+		case ShaderDataType::ubyte4:  return 1 * 4;
+		case ShaderDataType::ushort2: return 2 * 2;
+		case ShaderDataType::ushort4: return 2 * 4;
+		case ShaderDataType::half2:   return 2 * 2;
 		}
 		return 0;
 	}
@@ -61,6 +68,10 @@ namespace phx {
 			case ShaderDataType::int3: return 3;
 			case ShaderDataType::int4: return 4;
 			case ShaderDataType::Bool: return 1;
+			case ShaderDataType::ubyte4:  return 4;
+			case ShaderDataType::ushort2: return 2;
+			case ShaderDataType::ushort4: return 4;
+			case ShaderDataType::half2:   return 2;
 			}
 			return 0;
 		}
@@ -112,12 +123,45 @@ namespace phx {
 		virtual const BufferLayout& GetLayout() const = 0;
 		virtual void SetLayout(const BufferLayout& layout) = 0;
 
-		virtual void SetData(const void* data, uint32_t size) = 0;
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
 
 		static Ref<VertexBuffer> Create(uint32_t size);
 		static Ref<VertexBuffer> Create(float* vetices, uint32_t size);
 	};
 
+	// Vertex buffer that stays mapped for its whole lifetime so it can be written directly, without a staging copy.
+	// The storage is a ring with room for regionCount full regions. Each region starts where the previous one
+	// ended and only takes up what was written to it, so many small batches share the ring as well as a few
+	// full ones. Used space is fenced once its draws are submitted and is only handed out again after the GPU
+	// has finished reading it, so the ring should hold every batch of the frames the GPU may still be working on.
+	class StreamingVertexBuffer : public VertexBuffer
+	{
+	public:
+		virtual ~StreamingVertexBuffer() {}
+
+		// Returns a pointer to the current region, waiting first if the GPU is still reading any of it
+		virtual void* Map() = 0;
+		// Fences the first size bytes of the current region and starts the next region after them. Size must be a
+		// multiple of the vertex stride so regions stay aligned to whole vertices
+		virtual void Advance(uint32_t size) = 0;
+
+		// Byte offset of the current region from the start of the buffer
+		virtual uint32_t GetRegionOffset() const = 0;
+		virtual uint32_t GetRegionSize() const = 0;
+
+		static Ref<StreamingVertexBuffer> Create(uint32_t regionSize, uint32_t regionCount = 3);
+	};
+
+	enum class IndexType
+	{
+		UInt16 = 0, UInt32
+	};
+
+	inline uint32_t IndexTypeSize(IndexType type)
+	{
+		return type == IndexType::UInt16 ? 2 : 4;
+	}
+
 	class IndexBuffer
 	{
 	public:
@@ -127,8 +171,34 @@ namespace phx {
 		virtual void Unbind() const = 0;
 
 		virtual uint32_t GetCount() const = 0;
+		virtual IndexType GetType() const = 0;
 
+		static Ref<IndexBuffer> Create(uint16_t* indices, uint32_t count);
 		static Ref<IndexBuffer> Create(uint32_t* indices, uint32_t count);
 		static Ref<IndexBuffer> Create(Indice* indices, uint32_t count);
 	};
+
+	// Arguments of one indexed draw, in the layout the GPU reads from an IndirectBuffer
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t IndexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t BaseInstance;
+	};
+
+	// Holds DrawIndexedIndirectCommands, so many draws of one vertex array go out as a single call
+	class IndirectBuffer
+	{
+	public:
+		virtual ~IndirectBuffer() {}
+
+		virtual void Bind() const = 0;
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+		virtual uint32_t GetSize() const = 0;
+
+		static Ref<IndirectBuffer> Create(uint32_t size);
+	};
 }
\ No newline at end of file
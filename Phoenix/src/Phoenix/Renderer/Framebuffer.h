@@ -54,6 +54,13 @@ namespace phx {
 
 		virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) = 0;
 
+		// Asynchronous ReadPixel for integer attachments. The request is queued on the GPU with the framebuffer bound
+		// and returns at once, false when too many requests are still in flight. Results come back through
+		// PollPixel in request order, usually a frame or two later, without waiting for the GPU
+		virtual bool RequestPixel(uint32_t attachmentIndex, int x, int y) = 0;
+		// Takes the oldest request's value once it is finished, false while it is not. -1 if the read failed
+		virtual bool PollPixel(int& outValue) = 0;
+
 		virtual void ClearAttachment(uint32_t attachmentIndex, int value) = 0;
 
 		virtual uint32_t GetColorAttachmentRendererID(uint32_t index = 0) const = 0;
@@ -0,0 +1,170 @@
+#include "phxpch.h"
+#include "GPUProfiler.h"
+
+#include "Phoenix/Renderer/TimestampQueryPool.h"
+
+namespace phx {
+
+	struct GPUProfilerData
+	{
+		struct ScopeRecord
+		{
+			const char* Name;
+			uint32_t Depth;
+			uint32_t Begin;
+			uint32_t End = TimestampQueryPool::InvalidQuery;
+		};
+
+		struct Frame
+		{
+			Ref<TimestampQueryPool> Queries;
+			std::vector<ScopeRecord> Scopes;
+			bool InFlight = false;
+
+			// Both clocks read together when the frame began, to place its timestamps in the CPU trace
+			uint64_t GPUClock = 0;
+			std::chrono::steady_clock::time_point CPUClock;
+		};
+
+		bool Initialized = false;
+		Frame Frames[GPUProfiler::FramesInFlight];
+		uint32_t CurrentFrame = 0;
+		std::vector<uint32_t> OpenScopes; // Indices into the current frame's scopes, InvalidQuery when dropped
+		std::vector<uint64_t> Timestamps;
+
+		std::vector<GPUProfiler::PassTime> PassTimes;
+		float FrameMilliseconds = 0.0f;
+		uint32_t DroppedFrames = 0;
+	};
+
+	static GPUProfilerData s_Data;
+
+	static void ResolveFrame(GPUProfilerData::Frame& frame, const uint64_t* timestamps)
+	{
+		s_Data.PassTimes.clear();
+		uint64_t first = std::numeric_limits<uint64_t>::max();
+		uint64_t last = 0;
+
+		for (const auto& scope : frame.Scopes)
+		{
+			if (scope.End == TimestampQueryPool::InvalidQuery)
+				continue;
+
+			uint64_t begin = timestamps[scope.Begin];
+			uint64_t end = std::max(timestamps[scope.End], begin);
+			first = std::min(first, begin);
+			last = std::max(last, end);
+			s_Data.PassTimes.push_back({ scope.Name, scope.Depth, (float)((end - begin) / 1e6) });
+
+#if PHX_PROFILE
+			auto start = FloatingPointMicroseconds{ frame.CPUClock.time_since_epoch() } + FloatingPointMicroseconds{ ((double)begin - (double)frame.GPUClock) / 1e3 };
+			Instrumentor::Get().WriteGPUProfile({ scope.Name, start, std::chrono::microseconds((end - begin) / 1000), {} });
+#endif
+		}
+
+		s_Data.FrameMilliseconds = last > first ? (float)((last - first) / 1e6) : 0.0f;
+	}
+
+	void GPUProfiler::Init()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		for (auto& frame : s_Data.Frames)
+		{
+			frame.Queries = TimestampQueryPool::Create(MaxScopesPerFrame * 2);
+			frame.Scopes.reserve(MaxScopesPerFrame);
+		}
+		s_Data.Timestamps.resize(MaxScopesPerFrame * 2);
+		s_Data.Initialized = true;
+	}
+
+	void GPUProfiler::Shutdown()
+	{
+		for (auto& frame : s_Data.Frames)
+			frame = {};
+		s_Data.Initialized = false;
+	}
+
+	void GPUProfiler::BeginFrame()
+	{
+		if (!s_Data.Initialized)
+			return;
+
+		PHX_PROFILE_FUNCTION();
+
+		auto& current = s_Data.Frames[s_Data.CurrentFrame];
+		current.InFlight = !current.Scopes.empty();
+		s_Data.OpenScopes.clear();
+
+		// Oldest first, and a frame still running means every newer one is too
+		for (uint32_t i = 1; i <= FramesInFlight; i++)
+		{
+			auto& frame = s_Data.Frames[(s_Data.CurrentFrame + i) % FramesInFlight];
+			if (!frame.InFlight)
+				continue;
+			if (!frame.Queries->TryRead(s_Data.Timestamps.data()))
+				break;
+
+			ResolveFrame(frame, s_Data.Timestamps.data());
+			frame.InFlight = false;
+		}
+
+		s_Data.CurrentFrame = (s_Data.CurrentFrame + 1) % FramesInFlight;
+		auto& next = s_Data.Frames[s_Data.CurrentFrame];
+		if (next.InFlight)
+			s_Data.DroppedFrames++;
+
+		next.InFlight = false;
+		next.Queries->Reset();
+		next.Scopes.clear();
+		next.GPUClock = next.Queries->GetCurrentTimestamp();
+		next.CPUClock = std::chrono::steady_clock::now();
+	}
+
+	void GPUProfiler::BeginScope(const char* name)
+	{
+		if (!s_Data.Initialized)
+			return;
+
+		auto& frame = s_Data.Frames[s_Data.CurrentFrame];
+		uint32_t begin = frame.Scopes.size() < MaxScopesPerFrame ? frame.Queries->Write() : TimestampQueryPool::InvalidQuery;
+		if (begin == TimestampQueryPool::InvalidQuery)
+		{
+			s_Data.OpenScopes.push_back(TimestampQueryPool::InvalidQuery);
+			return;
+		}
+
+		s_Data.OpenScopes.push_back((uint32_t)frame.Scopes.size());
+		frame.Scopes.push_back({ name, (uint32_t)s_Data.OpenScopes.size() - 1, begin });
+	}
+
+	void GPUProfiler::EndScope()
+	{
+		if (s_Data.OpenScopes.empty())
+			return;
+
+		uint32_t scope = s_Data.OpenScopes.back();
+		s_Data.OpenScopes.pop_back();
+		if (scope != TimestampQueryPool::InvalidQuery)
+		{
+			auto& frame = s_Data.Frames[s_Data.CurrentFrame];
+			frame.Scopes[scope].End = frame.Queries->Write();
+		}
+	}
+
+	const std::vector<GPUProfiler::PassTime>& GPUProfiler::GetPassTimes()
+	{
+		return s_Data.PassTimes;
+	}
+
+	float GPUProfiler::GetFrameMilliseconds()
+	{
+		return s_Data.FrameMilliseconds;
+	}
+
+	uint32_t GPUProfiler::GetDroppedFrameCount()
+	{
+		return s_Data.DroppedFrames;
+	}
+
+}
\ No newline at end of file
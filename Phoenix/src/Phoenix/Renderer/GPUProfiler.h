@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+namespace phx {
+
+	// GPU time of named passes, measured with timestamps taken around them. Frames stay in flight for a few frames
+	// and are only read once the GPU has finished them, so timing never waits on the GPU. When the GPU falls that
+	// far behind, the oldest frame is dropped instead. With profiling on, each pass also goes into the
+	// Instrumentor trace as a separate GPU process
+	class GPUProfiler
+	{
+	public:
+		static constexpr uint32_t FramesInFlight = 4;
+		static constexpr uint32_t MaxScopesPerFrame = 128;
+
+		static void Init();
+		static void Shutdown();
+
+		// Reads back every finished frame and starts timing the next one. Scopes still open are dropped
+		static void BeginFrame();
+
+		// The name must outlive the frame, like a string literal. Scopes nest
+		static void BeginScope(const char* name);
+		static void EndScope();
+
+		struct PassTime
+		{
+			const char* Name;
+			uint32_t Depth;
+			float Milliseconds;
+		};
+
+		// Passes of the newest frame the GPU has finished, in the order they began
+		static const std::vector<PassTime>& GetPassTimes();
+		// From the start of the first pass to the end of the last one in that frame
+		static float GetFrameMilliseconds();
+		static uint32_t GetDroppedFrameCount();
+	};
+
+	class GPUProfileScope
+	{
+	public:
+		GPUProfileScope(const char* name) { GPUProfiler::BeginScope(name); }
+		~GPUProfileScope() { GPUProfiler::EndScope(); }
+
+		GPUProfileScope(const GPUProfileScope&) = delete;
+		GPUProfileScope& operator=(const GPUProfileScope&) = delete;
+	};
+
+}
\ No newline at end of file
@@ -4,6 +4,11 @@
 
 #include "RenderCommand.h"
 #include "Renderer.h"
+#include "Renderer3D.h"
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include "Phoenix/Utils/MappedFile.h"
 
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -12,6 +17,8 @@
 #include <glad/glad.h>
 #include <glm/glm/ext/matrix_transform.hpp>
 
+#include <fstream>
+
 namespace phx {
 
 	namespace {
@@ -25,35 +32,393 @@ namespace phx {
 			aiProcess_OptimizeMeshes |
 			aiProcess_Debone |
 			aiProcess_ValidateDataStructure;
+
+		// A cooked mesh is this header, then SubmeshCount Mesh::Submesh entries, then LodCount LOD errors, then
+		// LodCount * SubmeshCount Mesh::IndexRange entries, then VertexCount vertices, then IndexCount indices of
+		// IndexSize bytes holding every LOD of every submesh
+		struct CookedMeshHeader
+		{
+			char Magic[4] = { 'P', 'X', 'M', 'H' };
+			uint32_t Version = 5;
+			uint32_t VertexStride = sizeof(Mesh::Vertex);
+			uint32_t VertexCount = 0;
+			uint32_t IndexCount = 0;
+			uint32_t SubmeshCount = 0;
+			uint32_t LodCount = 0;
+			uint32_t IndexSize = 0;
+			uint64_t SourceSize = 0;
+			int64_t SourceWriteTime = 0;
+			glm::vec3 BoundingCenter = { 0.0f, 0.0f, 0.0f };
+			float BoundingRadius = 0.0f;
+			glm::vec3 BoundsMin = { 0.0f, 0.0f, 0.0f };
+			glm::vec3 BoundsMax = { 0.0f, 0.0f, 0.0f };
+		};
+
+		// Each LOD aims for half the triangles of the previous one, the chain ends early once simplification stalls
+		const float LodReduction = 0.5f;
+		const float LodMaxError = 0.1f; // Fraction of the submesh's extent
+		const uint32_t LodMinIndexCount = 3 * 32;
+
+		// One aiMesh, cooked on its own before being appended to the shared buffers
+		struct CookedSubmesh
+		{
+			std::vector<Mesh::Vertex> Vertices;
+			std::vector<std::vector<uint32_t>> LodIndices;
+			std::vector<float> LodErrors; // In mesh units
+			Math::AABB Bounds;
+		};
+
+		CookedSubmesh CookSubmesh(const aiMesh* mesh)
+		{
+			CookedSubmesh submesh;
+
+			std::vector<Mesh::Vertex> vertices;
+			vertices.reserve(mesh->mNumVertices);
+
+			for (size_t i = 0; i < vertices.capacity(); i++)
+			{
+				Mesh::Vertex vertex;
+				vertex.Position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
+				//vertex.Color = { mesh->mColors[i]->r, mesh->mColors[i]->g, mesh->mColors[i]->b, mesh->mColors[i]->a };
+				
+				vertices.push_back(vertex);
+			}
+
+			// SortByPType can leave points and lines in a mesh that also holds triangles
+			std::vector<uint32_t> indices;
+			indices.reserve((size_t)mesh->mNumFaces * 3);
+			for (size_t i = 0; i < mesh->mNumFaces; i++)
+			{
+				if (mesh->mFaces[i].mNumIndices != 3)
+					continue;
+
+				indices.push_back(mesh->mFaces[i].mIndices[0]);
+				indices.push_back(mesh->mFaces[i].mIndices[1]);
+				indices.push_back(mesh->mFaces[i].mIndices[2]);
+			}
+
+			std::vector<glm::vec3> positions(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++)
+				positions[i] = vertices[i].Position;
+
+			submesh.Bounds = { positions[0], positions[0] };
+			for (const glm::vec3& position : positions)
+			{
+				submesh.Bounds.Min = glm::min(submesh.Bounds.Min, position);
+				submesh.Bounds.Max = glm::max(submesh.Bounds.Max, position);
+			}
+
+			glm::vec3 center = submesh.Bounds.GetCenter();
+			float radius = 0.0f;
+			for (const glm::vec3& position : positions)
+				radius = std::max(radius, glm::length(position - center));
+
+			submesh.LodIndices = { std::move(indices) };
+			submesh.LodErrors = { 0.0f };
+
+			// Every LOD is simplified from the previous one, so errors add up along the chain
+			while (submesh.LodIndices.size() < Mesh::MaxLods && radius > 0.0f)
+			{
+				const std::vector<uint32_t>& previous = submesh.LodIndices.back();
+				uint32_t target = (uint32_t)(previous.size() * LodReduction) / 3 * 3;
+				if (target < LodMinIndexCount)
+					break;
+
+				float error;
+				std::vector<uint32_t> simplified = MeshSimplifier::Simplify(positions, previous, target, LodMaxError, &error);
+				if (simplified.empty() || simplified.size() > previous.size() * 0.9f)
+					break;
+
+				submesh.LodErrors.push_back(submesh.LodErrors.back() + error);
+				submesh.LodIndices.push_back(std::move(simplified));
+			}
+
+			std::vector<uint32_t> allIndices;
+			for (std::vector<uint32_t>& lod : submesh.LodIndices)
+			{
+				MeshOptimizer::OptimizeVertexCache(lod, (uint32_t)vertices.size());
+				MeshOptimizer::OptimizeOverdraw(lod, positions);
+				allIndices.insert(allIndices.end(), lod.begin(), lod.end());
+			}
+
+			// LOD 0 comes first, so vertices end up in the order the full detail submesh reads them
+			std::vector<uint32_t> remap = MeshOptimizer::OptimizeVertexFetch(allIndices, (uint32_t)vertices.size());
+			uint32_t usedCount = 0;
+			submesh.Vertices.resize(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				if (remap[i] != MeshOptimizer::UnusedVertex)
+				{
+					submesh.Vertices[remap[i]] = vertices[i];
+					usedCount++;
+				}
+			}
+			submesh.Vertices.resize(usedCount);
+
+			size_t offset = 0;
+			for (std::vector<uint32_t>& lod : submesh.LodIndices)
+			{
+				lod.assign(allIndices.begin() + offset, allIndices.begin() + offset + lod.size());
+				offset += lod.size();
+			}
+			return submesh;
+		}
+
+		const char* GetCacheDirectory()
+		{
+			return "assets/cache/mesh";
+		}
+
+		// Named after the source file, plus an FNV-1a hash of its normalized path so sources with the same name in
+		// different folders get their own cooked file
+		std::filesystem::path GetCookedPath(const std::filesystem::path& source)
+		{
+			std::error_code error;
+			std::filesystem::path normalized = std::filesystem::weakly_canonical(source, error);
+			if (error)
+				normalized = source.lexically_normal();
+
+			uint64_t hash = 14695981039346656037ull;
+			for (char c : normalized.generic_string())
+			{
+				hash ^= (uint8_t)c;
+				hash *= 1099511628211ull;
+			}
+
+			char suffix[24];
+			snprintf(suffix, sizeof(suffix), "-%016llx.phxmesh", (unsigned long long)hash);
+			return std::filesystem::path(GetCacheDirectory()) / (source.filename().string() + suffix);
+		}
+
+		// Every submesh and LOD range has to lie within the cooked vertices and indices, and every index within
+		// its submesh, or drawing the mesh would read past its buffers
+		bool ValidateCooked(const Mesh::Submesh* submeshes, uint32_t submeshCount, const Mesh::IndexRange* ranges, uint32_t lodCount,
+			uint32_t vertexCount, const void* indices, uint32_t indexCount, IndexType indexType)
+		{
+			for (uint32_t s = 0; s < submeshCount; s++)
+			{
+				const Mesh::Submesh& submesh = submeshes[s];
+				if ((uint64_t)submesh.BaseVertex + submesh.VertexCount > vertexCount)
+					return false;
+
+				for (uint32_t lod = 0; lod < lodCount; lod++)
+				{
+					const Mesh::IndexRange& range = ranges[lod * submeshCount + s];
+					if ((uint64_t)range.IndexOffset + range.IndexCount > indexCount)
+						return false;
+
+					for (uint32_t i = range.IndexOffset; i < range.IndexOffset + range.IndexCount; i++)
+					{
+						uint32_t index = indexType == IndexType::UInt16 ? ((const uint16_t*)indices)[i] : ((const uint32_t*)indices)[i];
+						if (index >= submesh.VertexCount)
+							return false;
+					}
+				}
+			}
+			return true;
+		}
 	}
 
 	Mesh::Mesh(const std::string& filename)
 		: m_FilePath(filename)
 	{
+		PHX_PROFILE_FUNCTION();
+
+		std::filesystem::path path = filename;
+		if (path.extension() == ".phxmesh")
+		{
+			if (!LoadCooked(path, 0, 0))
+				PHX_CORE_ERROR("Failed to load mesh: {0}", filename);
+			return;
+		}
+
+		std::error_code error;
+		uint64_t sourceSize = std::filesystem::file_size(path, error);
+		int64_t sourceWriteTime = error ? 0 : (int64_t)std::filesystem::last_write_time(path, error).time_since_epoch().count();
+		if (error)
+		{
+			PHX_CORE_ERROR("Failed to load mesh: {0}", filename);
+			return;
+		}
+
+		std::filesystem::path cookedPath = GetCookedPath(path);
+		if (!LoadCooked(cookedPath, sourceSize, sourceWriteTime))
+			Import(cookedPath, sourceSize, sourceWriteTime);
+	}
+
+	bool Mesh::LoadCooked(const std::filesystem::path& cookedPath, uint64_t sourceSize, int64_t sourceWriteTime)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		MappedFile file(cookedPath.string());
+		if (!file.IsValid() || file.GetSize() < sizeof(CookedMeshHeader))
+			return false;
+
+		CookedMeshHeader expected;
+		const CookedMeshHeader* header = (const CookedMeshHeader*)file.GetData();
+		if (memcmp(header->Magic, expected.Magic, sizeof(expected.Magic)) != 0
+			|| header->Version != expected.Version || header->VertexStride != expected.VertexStride)
+			return false;
+
+		if (sourceSize != 0 && (header->SourceSize != sourceSize || header->SourceWriteTime != sourceWriteTime))
+			return false;
+
+		size_t submeshesSize = (size_t)header->SubmeshCount * sizeof(Submesh);
+		size_t errorsSize = (size_t)header->LodCount * sizeof(float);
+		size_t rangesSize = (size_t)header->LodCount * header->SubmeshCount * sizeof(IndexRange);
+		size_t verticesSize = (size_t)header->VertexCount * sizeof(Vertex);
+		size_t indicesSize = (size_t)header->IndexCount * header->IndexSize;
+		if (header->IndexSize != sizeof(uint16_t) && header->IndexSize != sizeof(uint32_t))
+			return false;
+		if (header->SubmeshCount == 0 || header->LodCount == 0
+			|| file.GetSize() < sizeof(CookedMeshHeader) + submeshesSize + errorsSize + rangesSize + verticesSize + indicesSize)
+			return false;
+
+		const uint8_t* data = file.GetData() + sizeof(CookedMeshHeader);
+		const Submesh* submeshes = (const Submesh*)data;
+		const float* lodErrors = (const float*)(data + submeshesSize);
+		const IndexRange* lodRanges = (const IndexRange*)(data + submeshesSize + errorsSize);
+		const Vertex* vertices = (const Vertex*)(data + submeshesSize + errorsSize + rangesSize);
+		const uint8_t* indices = data + submeshesSize + errorsSize + rangesSize + verticesSize;
+
+		IndexType indexType = header->IndexSize == sizeof(uint16_t) ? IndexType::UInt16 : IndexType::UInt32;
+		if (!ValidateCooked(submeshes, header->SubmeshCount, lodRanges, header->LodCount, header->VertexCount, indices, header->IndexCount, indexType))
+		{
+			PHX_CORE_WARN("Cooked mesh {0} is corrupt", cookedPath.string());
+			return false;
+		}
+
+		m_Submeshes.assign(submeshes, submeshes + header->SubmeshCount);
+		m_LodErrors.assign(lodErrors, lodErrors + header->LodCount);
+		m_LodRanges.assign(lodRanges, lodRanges + (size_t)header->LodCount * header->SubmeshCount);
+
+		m_Bounds = { header->BoundsMin, header->BoundsMax };
+		m_BoundingCenter = header->BoundingCenter;
+		m_BoundingRadius = header->BoundingRadius;
+
+		Upload(vertices, header->VertexCount, indices, header->IndexCount, indexType);
+		return true;
+	}
+
+	void Mesh::Import(const std::filesystem::path& cookedPath, uint64_t sourceSize, int64_t sourceWriteTime)
+	{
+		PHX_PROFILE_FUNCTION();
+
 		Assimp::Importer importer;
 
-		const aiScene* scene = importer.ReadFile(filename, ImportFlags);
+		const aiScene* scene = importer.ReadFile(m_FilePath, ImportFlags);
 
 		if (!scene || !scene->HasMeshes())
 		{
-			PHX_CORE_ERROR("Failed to load mesh: {0}", filename);
+			PHX_CORE_ERROR("Failed to load mesh: {0}", m_FilePath);
+			return;
+		}
+
+		std::vector<CookedSubmesh> cooked;
+		for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+		{
+			const aiMesh* mesh = scene->mMeshes[i];
+			if ((mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) && mesh->mNumVertices > 0)
+				cooked.push_back(CookSubmesh(mesh));
+		}
+
+		if (cooked.empty())
+		{
+			PHX_CORE_ERROR("Failed to load mesh: {0}, it has no triangles", m_FilePath);
 			return;
 		}
 
-		aiMesh* mesh = scene->mMeshes[0];
+		m_Bounds = cooked[0].Bounds;
+		uint32_t lodCount = 0;
+		bool shortIndices = true;
+		for (const CookedSubmesh& submesh : cooked)
+		{
+			m_Bounds.Grow(submesh.Bounds);
+			lodCount = std::max(lodCount, (uint32_t)submesh.LodIndices.size());
+			shortIndices = shortIndices && submesh.Vertices.size() <= 0x10000;
+		}
+
+		m_BoundingCenter = m_Bounds.GetCenter();
+		m_BoundingRadius = 0.0f;
+		for (const CookedSubmesh& submesh : cooked)
+			for (const Vertex& vertex : submesh.Vertices)
+				m_BoundingRadius = std::max(m_BoundingRadius, glm::length(vertex.Position - m_BoundingCenter));
+
+		// Submeshes keep indices relative to their own vertices, drawn with a base vertex, so 16-bit indices only
+		// need every submesh to fit rather than the whole mesh
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		m_Submeshes.clear();
+		m_LodErrors.assign(lodCount, 0.0f);
+		m_LodRanges.assign((size_t)lodCount * cooked.size(), {});
+		for (size_t s = 0; s < cooked.size(); s++)
+		{
+			const CookedSubmesh& submesh = cooked[s];
+			m_Submeshes.push_back({ (uint32_t)vertices.size(), (uint32_t)submesh.Vertices.size(), submesh.Bounds });
+			vertices.insert(vertices.end(), submesh.Vertices.begin(), submesh.Vertices.end());
+
+			for (uint32_t lod = 0; lod < lodCount; lod++)
+			{
+				uint32_t source = std::min(lod, (uint32_t)submesh.LodIndices.size() - 1);
+				IndexRange& range = m_LodRanges[lod * cooked.size() + s];
+				if (source == lod)
+				{
+					range = { (uint32_t)indices.size(), (uint32_t)submesh.LodIndices[lod].size() };
+					indices.insert(indices.end(), submesh.LodIndices[lod].begin(), submesh.LodIndices[lod].end());
+				}
+				else
+				{
+					range = m_LodRanges[source * cooked.size() + s];
+				}
+
+				if (m_BoundingRadius > 0.0f)
+					m_LodErrors[lod] = std::max(m_LodErrors[lod], submesh.LodErrors[source] / m_BoundingRadius);
+			}
+		}
+
+		IndexType indexType = shortIndices ? IndexType::UInt16 : IndexType::UInt32;
+		std::vector<uint16_t> shortIndexData;
+		if (indexType == IndexType::UInt16)
+			shortIndexData.assign(indices.begin(), indices.end());
+
+		const void* indexData = indexType == IndexType::UInt16 ? (const void*)shortIndexData.data() : (const void*)indices.data();
+		uint32_t indexSize = IndexTypeSize(indexType);
+
+		Upload(vertices.data(), (uint32_t)vertices.size(), indexData, (uint32_t)indices.size(), indexType);
 
-		m_Vertices.reserve(mesh->mNumVertices);
+		CookedMeshHeader header;
+		header.VertexCount = (uint32_t)vertices.size();
+		header.IndexCount = (uint32_t)indices.size();
+		header.SubmeshCount = (uint32_t)m_Submeshes.size();
+		header.LodCount = lodCount;
+		header.IndexSize = indexSize;
+		header.SourceSize = sourceSize;
+		header.SourceWriteTime = sourceWriteTime;
+		header.BoundingCenter = m_BoundingCenter;
+		header.BoundingRadius = m_BoundingRadius;
+		header.BoundsMin = m_Bounds.Min;
+		header.BoundsMax = m_Bounds.Max;
 
-		for (size_t i = 0; i < m_Vertices.capacity(); i++)
+		std::error_code error;
+		std::filesystem::create_directories(cookedPath.parent_path(), error);
+
+		std::ofstream out(cookedPath, std::ios::out | std::ios::binary);
+		if (out.is_open())
 		{
-			Vertex vertex;
-			vertex.Position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
-			//vertex.Color = { mesh->mColors[i]->r, mesh->mColors[i]->g, mesh->mColors[i]->b, mesh->mColors[i]->a };
-			
-			m_Vertices.push_back(vertex);
+			out.write((const char*)&header, sizeof(header));
+			out.write((const char*)m_Submeshes.data(), m_Submeshes.size() * sizeof(Submesh));
+			out.write((const char*)m_LodErrors.data(), m_LodErrors.size() * sizeof(float));
+			out.write((const char*)m_LodRanges.data(), m_LodRanges.size() * sizeof(IndexRange));
+			out.write((const char*)vertices.data(), vertices.size() * sizeof(Vertex));
+			out.write((const char*)indexData, indices.size() * indexSize);
+			out.flush();
+			out.close();
 		}
+	}
 
-		m_VertexBuffer = VertexBuffer::Create(m_Vertices.size() * sizeof(Vertex));
+	void Mesh::Upload(const Vertex* vertices, uint32_t vertexCount, const void* indices, uint32_t indexCount, IndexType indexType)
+	{
+		m_VertexBuffer = VertexBuffer::Create((float*)vertices, vertexCount * sizeof(Vertex));
 		m_VertexBuffer->SetLayout({
 			{ ShaderDataType::vec3, "a_Position"      },
 			{ ShaderDataType::vec4, "a_Color"         },
@@ -62,19 +427,44 @@ namespace phx {
 			{ ShaderDataType::Float, "a_TilingFactor" },
 			{ ShaderDataType::Int, "a_EntityID"       }
 			});
-		m_VertexBuffer->SetData(m_Vertices.data(), m_Vertices.size() * sizeof(Vertex));
 
 		m_VertexArray = VertexArray::Create();
 		m_VertexArray->AddVertexBuffer(m_VertexBuffer);
+		m_VertexArray->AddInstanceBuffer(Renderer3D::GetObjectIndexBuffer());
+
+		if (indexType == IndexType::UInt16)
+			m_IndexBuffer = IndexBuffer::Create((uint16_t*)indices, indexCount);
+		else
+			m_IndexBuffer = IndexBuffer::Create((uint32_t*)indices, indexCount);
+		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
+
+		BuildOccluderGeometry(vertices, vertexCount, indices, indexType);
+	}
+
+	void Mesh::BuildOccluderGeometry(const Vertex* vertices, uint32_t vertexCount, const void* indices, IndexType indexType)
+	{
+		m_OccluderGeometry = {};
+		if (m_LodRanges.empty())
+			return;
 
-		//m_Indices.reserve(mesh->mNumFaces * 3);
-		for (size_t i = 0; i < mesh->mNumFaces; i++)
+		// Only the vertices the coarsest LOD uses are kept
+		uint32_t lod = GetLodCount() - 1;
+		std::vector<uint32_t> remap(vertexCount, MeshOptimizer::UnusedVertex);
+		for (uint32_t s = 0; s < (uint32_t)m_Submeshes.size(); s++)
 		{
-			m_Indices.push_back(mesh->mFaces[i].mIndices[0]);
-			m_Indices.push_back(mesh->mFaces[i].mIndices[1]);
-			m_Indices.push_back(mesh->mFaces[i].mIndices[2]);
+			const IndexRange& range = GetLodRange(lod, s);
+			for (uint32_t i = range.IndexOffset; i < range.IndexOffset + range.IndexCount; i++)
+			{
+				uint32_t index = indexType == IndexType::UInt16 ? ((const uint16_t*)indices)[i] : ((const uint32_t*)indices)[i];
+				index += m_Submeshes[s].BaseVertex;
+
+				if (remap[index] == MeshOptimizer::UnusedVertex)
+				{
+					remap[index] = (uint32_t)m_OccluderGeometry.Positions.size();
+					m_OccluderGeometry.Positions.push_back(vertices[index].Position);
+				}
+				m_OccluderGeometry.Indices.push_back(remap[index]);
+			}
 		}
-		m_IndexBuffer = IndexBuffer::Create(m_Indices.data(), m_Indices.size() * 4);
-		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
 	}
 }
\ No newline at end of file
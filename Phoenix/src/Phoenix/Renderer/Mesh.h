@@ -5,9 +5,19 @@
 #include "Phoenix/Renderer/Shader.h"
 #include "Phoenix/Renderer/Camera.h"
 
+#include "Phoenix/Math/AABB.h"
+
 #include "../vendor/glm/glm/glm.hpp"
 
 namespace phx {
+	// Geometry of every triangle mesh in a model file, as submeshes sharing one vertex and one index buffer. The first
+	// load imports the file through Assimp and cooks the result into assets/cache/mesh as a .phxmesh file, holding the
+	// vertex and index streams in the layout they are uploaded in. Later loads map the cooked file and upload straight
+	// from the mapping. Cooked files record the size and write time of their source and are cooked again once it
+	// changes. A .phxmesh file can also be loaded directly.
+	// Cooking also simplifies each submesh into a chain of LODs, each about half the triangles of the previous one.
+	// They index the same vertices and are stored one after the other in the index buffer. Every LOD is reordered for
+	// the vertex cache and overdraw, vertices are laid out in fetch order, and indices are 16 bit whenever they fit
 	class Mesh
 	{
 	public:
@@ -24,17 +34,63 @@ namespace phx {
 		};
 
 		static const int NumAttributes = 5;
+		static constexpr uint32_t MaxLods = 4;
+
+		// Indices are relative to the submesh's base vertex
+		struct Submesh
+		{
+			uint32_t BaseVertex = 0;
+			uint32_t VertexCount = 0;
+			Math::AABB Bounds;
+		};
+
+		struct IndexRange
+		{
+			uint32_t IndexOffset = 0;
+			uint32_t IndexCount = 0;
+		};
+
+		const std::vector<Submesh>& GetSubmeshes() const { return m_Submeshes; }
+
+		// LODs are picked for the whole mesh. Submeshes with shorter chains repeat their last LOD
+		uint32_t GetLodCount() const { return (uint32_t)m_LodErrors.size(); }
+		// Furthest the surface of any submesh moved from LOD 0, relative to the bounding radius
+		float GetLodError(uint32_t lod) const { return m_LodErrors[lod]; }
+		const IndexRange& GetLodRange(uint32_t lod, uint32_t submesh) const { return m_LodRanges[lod * m_Submeshes.size() + submesh]; }
+
+		// CPU copy of the coarsest LOD of every submesh, for meshes rasterized as occluders
+		struct OccluderGeometry
+		{
+			std::vector<glm::vec3> Positions;
+			std::vector<uint32_t> Indices;
+		};
+		const OccluderGeometry& GetOccluderGeometry() const { return m_OccluderGeometry; }
+
+		const Math::AABB& GetBounds() const { return m_Bounds; }
+		const glm::vec3& GetBoundingCenter() const { return m_BoundingCenter; }
+		float GetBoundingRadius() const { return m_BoundingRadius; }
 
 		inline const std::string& GetFilePath() const { return m_FilePath; }
 		glm::vec3 m_Position = glm::vec3(0,0,0);
-		std::vector<Vertex> m_Vertices;
 		Ref<VertexArray> m_VertexArray;
 	private:
-		std::vector<uint32_t> m_Indices;
-
+		// Checking the source is skipped when sourceSize is 0
+		bool LoadCooked(const std::filesystem::path& cookedPath, uint64_t sourceSize, int64_t sourceWriteTime);
+		void Import(const std::filesystem::path& cookedPath, uint64_t sourceSize, int64_t sourceWriteTime);
+		void Upload(const Vertex* vertices, uint32_t vertexCount, const void* indices, uint32_t indexCount, IndexType indexType);
+		void BuildOccluderGeometry(const Vertex* vertices, uint32_t vertexCount, const void* indices, IndexType indexType);
+	private:
 		Ref<VertexBuffer> m_VertexBuffer;
 		Ref<IndexBuffer> m_IndexBuffer;
 
+		std::vector<Submesh> m_Submeshes;
+		std::vector<float> m_LodErrors;
+		std::vector<IndexRange> m_LodRanges; // LOD-major, one per submesh
+		OccluderGeometry m_OccluderGeometry;
+		Math::AABB m_Bounds;
+		glm::vec3 m_BoundingCenter = { 0.0f, 0.0f, 0.0f };
+		float m_BoundingRadius = 0.0f;
+
 		std::string m_FilePath;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "phxpch.h"
+#include "MeshCache.h"
+
+#include <fstream>
+
+namespace phx {
+
+	std::unordered_map<std::string, MeshCache::Entry> MeshCache::s_Entries;
+	std::mutex MeshCache::s_Mutex;
+
+	// FNV-1a over the whole file
+	static uint64_t HashFile(const std::filesystem::path& path)
+	{
+		uint64_t hash = 14695981039346656037ull;
+
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		char buffer[64 * 1024];
+		while (in)
+		{
+			in.read(buffer, sizeof(buffer));
+			std::streamsize count = in.gcount();
+			for (std::streamsize i = 0; i < count; i++)
+			{
+				hash ^= (uint8_t)buffer[i];
+				hash *= 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
+	Ref<Mesh> MeshCache::Load(const std::string& filepath)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		std::error_code error;
+		std::filesystem::path path = std::filesystem::weakly_canonical(filepath, error);
+		if (error)
+			path = std::filesystem::path(filepath).lexically_normal();
+		std::string key = path.generic_string();
+
+		auto writeTime = std::filesystem::last_write_time(path, error);
+		uintmax_t size = error ? 0 : std::filesystem::file_size(path, error);
+		bool exists = !error;
+
+		if (!exists)
+			return CreateRef<Mesh>(filepath); // Logs the failure, not cached so the next load tries again
+
+		// Files of another size cannot hold the same contents, so only loaded files matching it are compared
+		struct Candidate
+		{
+			std::string Key;
+			Ref<Mesh> Cached;
+			std::filesystem::file_time_type WriteTime;
+			uint64_t ContentHash;
+		};
+		std::vector<Candidate> candidates;
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+
+			auto it = s_Entries.find(key);
+			if (it != s_Entries.end() && it->second.WriteTime == writeTime && it->second.Size == size)
+			{
+				if (Ref<Mesh> mesh = it->second.Cached.lock())
+					return mesh;
+			}
+
+			for (const auto& [otherKey, other] : s_Entries)
+			{
+				if (other.Size != size || otherKey == key)
+					continue;
+				if (Ref<Mesh> mesh = other.Cached.lock())
+					candidates.push_back({ otherKey, mesh, other.WriteTime, other.ContentHash });
+			}
+		}
+
+		// Hashing and importing run unlocked, so loads of other files are not held up behind them
+		uint64_t contentHash = 0;
+		Ref<Mesh> mesh;
+		if (!candidates.empty())
+		{
+			contentHash = HashFile(path);
+			for (Candidate& candidate : candidates)
+			{
+				// A candidate modified since its import no longer matches its mesh
+				if (!candidate.ContentHash)
+				{
+					auto candidateWriteTime = std::filesystem::last_write_time(candidate.Key, error);
+					if (error || candidateWriteTime != candidate.WriteTime)
+						continue;
+					candidate.ContentHash = HashFile(candidate.Key);
+				}
+
+				if (candidate.ContentHash == contentHash)
+				{
+					mesh = candidate.Cached;
+					break;
+				}
+			}
+		}
+
+		if (!mesh)
+			mesh = CreateRef<Mesh>(filepath);
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		// Hashes computed for the candidates are kept, as long as they still describe the same file
+		for (const Candidate& candidate : candidates)
+		{
+			auto it = s_Entries.find(candidate.Key);
+			if (it != s_Entries.end() && it->second.WriteTime == candidate.WriteTime && it->second.Cached.lock() == candidate.Cached)
+				it->second.ContentHash = candidate.ContentHash;
+		}
+
+		// Another thread may have loaded the same file meanwhile. Its mesh wins so both callers share one
+		Entry& entry = s_Entries[key];
+		if (entry.WriteTime == writeTime && entry.Size == size)
+		{
+			if (Ref<Mesh> loaded = entry.Cached.lock())
+				return loaded;
+		}
+
+		entry.Cached = mesh;
+		entry.WriteTime = writeTime;
+		entry.Size = size;
+		entry.ContentHash = contentHash;
+		return mesh;
+	}
+
+	void MeshCache::Collect()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		for (auto it = s_Entries.begin(); it != s_Entries.end();)
+			it = it->second.Cached.expired() ? s_Entries.erase(it) : std::next(it);
+	}
+
+	void MeshCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		s_Entries.clear();
+	}
+}
\ No newline at end of file
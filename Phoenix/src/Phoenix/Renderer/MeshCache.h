@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Phoenix/Renderer/Mesh.h"
+
+#include <mutex>
+
+namespace phx {
+
+	// Meshes shared across components. A file is imported once and its mesh lives as long as any handle to it, so
+	// copying components (duplicating entities, entering Play mode) copies a pointer instead of geometry.
+	// Files with identical contents share one mesh even when reached through different paths. Contents are only
+	// hashed when a file of the same size is already loaded, and never while the cache is locked
+	class MeshCache
+	{
+	public:
+		// Imports the file on first use. Returns the cached mesh while the file is unchanged on disk, and imports it
+		// again once it was modified
+		static Ref<Mesh> Load(const std::string& filepath);
+
+		// Drops the entries whose meshes are no longer referenced
+		static void Collect();
+		static void Clear();
+	private:
+		struct Entry
+		{
+			std::weak_ptr<phx::Mesh> Cached;
+			std::filesystem::file_time_type WriteTime;
+			uintmax_t Size = 0;
+			uint64_t ContentHash = 0; // 0 until a file of the same size is loaded
+		};
+
+		static std::unordered_map<std::string, Entry> s_Entries; // Keyed by normalized path
+		static std::mutex s_Mutex;
+	};
+}
\ No newline at end of file
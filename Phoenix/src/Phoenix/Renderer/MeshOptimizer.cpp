@@ -0,0 +1,267 @@
+#include "phxpch.h"
+#include "MeshOptimizer.h"
+
+namespace phx {
+
+	namespace {
+		const uint32_t VertexCacheSize = 32;
+
+		// Forsyth's scores: the three most recent vertices score flat so the next triangle does not just reuse the
+		// last one, older entries fade out, and vertices with few triangles left are favoured so they get finished
+		float VertexScore(int cachePosition, uint32_t remainingTriangles)
+		{
+			if (remainingTriangles == 0)
+				return -1.0f;
+
+			float score = 0.0f;
+			if (cachePosition >= 0)
+			{
+				if (cachePosition < 3)
+					score = 0.75f;
+				else
+					score = std::pow(1.0f - (float)(cachePosition - 3) / (VertexCacheSize - 3), 1.5f);
+			}
+			return score + 2.0f / std::sqrt((float)remainingTriangles);
+		}
+
+		// Cache misses of a FIFO cache, the kind most hardware approximates
+		uint32_t SimulateCacheMisses(const uint32_t* indices, size_t indexCount, std::vector<uint32_t>& timestamps, uint32_t& time)
+		{
+			const uint32_t FifoSize = 16;
+
+			uint32_t misses = 0;
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				uint32_t& timestamp = timestamps[indices[i]];
+				if (time - timestamp > FifoSize)
+				{
+					timestamp = time++;
+					misses++;
+				}
+			}
+			return misses;
+		}
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		if (triangleCount == 0)
+			return;
+
+		// Triangles of every vertex, the first Remaining[v] of them are not emitted yet
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		for (uint32_t index : indices)
+			offsets[index + 1]++;
+		for (uint32_t v = 0; v < vertexCount; v++)
+			offsets[v + 1] += offsets[v];
+
+		std::vector<uint32_t> remaining(vertexCount, 0);
+		std::vector<uint32_t> adjacency(indices.size());
+		for (uint32_t t = 0; t < triangleCount; t++)
+			for (uint32_t e = 0; e < 3; e++)
+			{
+				uint32_t v = indices[t * 3 + e];
+				adjacency[offsets[v] + remaining[v]++] = t;
+			}
+
+		std::vector<int> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			vertexScores[v] = VertexScore(-1, remaining[v]);
+
+		std::vector<float> triangleScores(triangleCount);
+		for (uint32_t t = 0; t < triangleCount; t++)
+			triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+		std::vector<uint8_t> emitted(triangleCount, 0);
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+
+		uint32_t cache[VertexCacheSize + 3];
+		uint32_t cacheCount = 0;
+		uint32_t nextCandidate = 0; // Triangles before it are all emitted
+
+		uint32_t best = 0;
+		while (true)
+		{
+			emitted[best] = 1;
+			const uint32_t* triangle = &indices[best * 3];
+			result.insert(result.end(), triangle, triangle + 3);
+
+			for (uint32_t e = 0; e < 3; e++)
+			{
+				uint32_t v = triangle[e];
+				uint32_t* vertexTriangles = &adjacency[offsets[v]];
+				for (uint32_t i = 0; i < remaining[v]; i++)
+				{
+					if (vertexTriangles[i] == best)
+					{
+						vertexTriangles[i] = vertexTriangles[--remaining[v]];
+						break;
+					}
+				}
+			}
+
+			// Move the triangle's vertices to the front, then shift the rest back
+			uint32_t newCache[VertexCacheSize + 3];
+			uint32_t newCount = 0;
+			for (uint32_t e = 0; e < 3; e++)
+				newCache[newCount++] = triangle[e];
+			for (uint32_t i = 0; i < cacheCount; i++)
+			{
+				uint32_t v = cache[i];
+				if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+					newCache[newCount++] = v;
+			}
+
+			for (uint32_t i = 0; i < newCount; i++)
+				cachePositions[newCache[i]] = i < VertexCacheSize ? (int)i : -1;
+
+			// Rescore everything the cache touched and pick the best triangle among them
+			float bestScore = -1.0f;
+			for (uint32_t i = 0; i < newCount; i++)
+			{
+				uint32_t v = newCache[i];
+				float score = VertexScore(cachePositions[v], remaining[v]);
+				float delta = score - vertexScores[v];
+				vertexScores[v] = score;
+
+				for (uint32_t j = 0; j < remaining[v]; j++)
+				{
+					uint32_t t = adjacency[offsets[v] + j];
+					triangleScores[t] += delta;
+					if (triangleScores[t] > bestScore)
+					{
+						bestScore = triangleScores[t];
+						best = t;
+					}
+				}
+			}
+
+			cacheCount = std::min(newCount, VertexCacheSize);
+			std::copy(newCache, newCache + cacheCount, cache);
+
+			// Nothing in the cache has triangles left, start over from the next unemitted triangle
+			if (bestScore < 0.0f)
+			{
+				while (nextCandidate < triangleCount && emitted[nextCandidate])
+					nextCandidate++;
+				if (nextCandidate == triangleCount)
+					break;
+				best = nextCandidate;
+			}
+		}
+
+		indices = std::move(result);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions, float threshold)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		if (triangleCount == 0)
+			return;
+
+		std::vector<uint32_t> timestamps(positions.size(), 0);
+		uint32_t time = (uint32_t)positions.size() + 32; // Every vertex starts out of the cache
+
+		// Hard boundaries fall where a triangle misses on all three vertices, the cache optimizer started over there.
+		// The first cluster always starts at the first triangle, which need not miss three times when it is degenerate
+		std::vector<uint32_t> hardClusters = { 0 };
+		SimulateCacheMisses(&indices[0], 3, timestamps, time);
+		for (uint32_t t = 1; t < triangleCount; t++)
+			if (SimulateCacheMisses(&indices[t * 3], 3, timestamps, time) == 3)
+				hardClusters.push_back(t);
+
+		// Soft boundaries split hard clusters wherever stopping costs little cache efficiency
+		std::vector<uint32_t> clusters;
+		for (size_t c = 0; c < hardClusters.size(); c++)
+		{
+			uint32_t begin = hardClusters[c];
+			uint32_t end = c + 1 < hardClusters.size() ? hardClusters[c + 1] : triangleCount;
+
+			time += 32;
+			float clusterMissRate = (float)SimulateCacheMisses(&indices[begin * 3], (end - begin) * 3, timestamps, time) / (end - begin);
+
+			time += 32;
+			uint32_t start = begin, misses = 0;
+			clusters.push_back(begin);
+			for (uint32_t t = begin; t < end; t++)
+			{
+				misses += SimulateCacheMisses(&indices[t * 3], 3, timestamps, time);
+				if (t + 1 < end && t > start && (float)misses / (t + 1 - start) <= clusterMissRate * threshold)
+				{
+					clusters.push_back(t + 1);
+					start = t + 1;
+					misses = 0;
+					time += 32;
+				}
+			}
+		}
+
+		glm::vec3 meshCentroid = glm::vec3(0.0f);
+		for (uint32_t index : indices)
+			meshCentroid += positions[index];
+		meshCentroid /= (float)indices.size();
+
+		// Clusters facing away from the mesh's centre sit on its outside and are the likeliest occluders
+		struct Cluster
+		{
+			uint32_t Begin, End;
+			float SortKey;
+		};
+		std::vector<Cluster> sorted(clusters.size());
+		for (size_t c = 0; c < clusters.size(); c++)
+		{
+			uint32_t begin = clusters[c];
+			uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+			glm::vec3 centroid = glm::vec3(0.0f), normal = glm::vec3(0.0f);
+			float area = 0.0f;
+			for (uint32_t t = begin; t < end; t++)
+			{
+				const glm::vec3& p0 = positions[indices[t * 3]];
+				const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+				const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+				glm::vec3 triangleNormal = glm::cross(p1 - p0, p2 - p0);
+				float triangleArea = glm::length(triangleNormal);
+
+				centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+				normal += triangleNormal;
+				area += triangleArea;
+			}
+
+			float normalLength = glm::length(normal);
+			if (area > 0.0f && normalLength > 0.0f)
+				sorted[c] = { begin, end, glm::dot(centroid / area - meshCentroid, normal / normalLength) };
+			else
+				sorted[c] = { begin, end, 0.0f };
+		}
+		std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.SortKey > b.SortKey; });
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (const Cluster& cluster : sorted)
+			result.insert(result.end(), indices.begin() + cluster.Begin * 3, indices.begin() + cluster.End * 3);
+		indices = std::move(result);
+	}
+
+	std::vector<uint32_t> MeshOptimizer::OptimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		std::vector<uint32_t> remap(vertexCount, UnusedVertex);
+		uint32_t next = 0;
+		for (uint32_t& index : indices)
+		{
+			if (remap[index] == UnusedVertex)
+				remap[index] = next++;
+			index = remap[index];
+		}
+		return remap;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace phx {
+	// Index and vertex reordering run once at import. None of them change what is drawn, only the order: triangles
+	// that share vertices are drawn close together so the post-transform cache hits, clusters facing out from the
+	// mesh are drawn first so they occlude the rest, and vertices are laid out in the order they are first used
+	class MeshOptimizer
+	{
+	public:
+		// Forsyth's linear-speed vertex cache optimization, tuned for a 32 entry LRU cache
+		static void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+		// Splits the cache-optimized triangle order into clusters and sorts them outside-in. Clusters end where the
+		// cache miss rate so far is within threshold of the whole cluster's, so larger thresholds trade vertex cache
+		// efficiency for smaller clusters and less overdraw
+		static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions, float threshold = 1.05f);
+
+		// Renumbers vertices in order of first use and rewrites indices to match. Returns the new index of every old
+		// vertex, or UnusedVertex when no index refers to it
+		static constexpr uint32_t UnusedVertex = ~0u;
+		static std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount);
+	};
+}
\ No newline at end of file
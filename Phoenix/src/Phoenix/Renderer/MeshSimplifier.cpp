@@ -0,0 +1,316 @@
+#include "phxpch.h"
+#include "MeshSimplifier.h"
+
+#include <cfloat>
+
+namespace phx {
+
+	namespace {
+		// Weighted sum of squared distances to a set of planes, as the symmetric matrix [A b; b^T c]. Evaluate
+		// divides by the total weight, so errors read as squared distances whatever the triangle sizes
+		struct Quadric
+		{
+			float A00 = 0.0f, A01 = 0.0f, A02 = 0.0f, A11 = 0.0f, A12 = 0.0f, A22 = 0.0f;
+			float B0 = 0.0f, B1 = 0.0f, B2 = 0.0f;
+			float C = 0.0f;
+			float Weight = 0.0f;
+
+			static Quadric FromPlane(const glm::vec3& n, float d, float weight)
+			{
+				Quadric q;
+				q.A00 = weight * n.x * n.x; q.A01 = weight * n.x * n.y; q.A02 = weight * n.x * n.z;
+				q.A11 = weight * n.y * n.y; q.A12 = weight * n.y * n.z;
+				q.A22 = weight * n.z * n.z;
+				q.B0 = weight * n.x * d; q.B1 = weight * n.y * d; q.B2 = weight * n.z * d;
+				q.C = weight * d * d;
+				q.Weight = weight;
+				return q;
+			}
+
+			void Add(const Quadric& q)
+			{
+				A00 += q.A00; A01 += q.A01; A02 += q.A02;
+				A11 += q.A11; A12 += q.A12;
+				A22 += q.A22;
+				B0 += q.B0; B1 += q.B1; B2 += q.B2;
+				C += q.C;
+				Weight += q.Weight;
+			}
+
+			float Evaluate(const glm::vec3& p) const
+			{
+				float rx = A00 * p.x + A01 * p.y + A02 * p.z;
+				float ry = A01 * p.x + A11 * p.y + A12 * p.z;
+				float rz = A02 * p.x + A12 * p.y + A22 * p.z;
+				float error = p.x * rx + p.y * ry + p.z * rz + 2.0f * (B0 * p.x + B1 * p.y + B2 * p.z) + C;
+				return Weight > 0.0f ? std::abs(error) / Weight : 0.0f;
+			}
+		};
+
+		struct Collapse
+		{
+			uint32_t From, To;
+			float Cost;
+		};
+
+		// Border edges are pinned much harder than surfaces so open meshes keep their outline
+		const float BorderWeight = 10.0f;
+
+		uint64_t EdgeKey(uint32_t a, uint32_t b)
+		{
+			return a < b ? (uint64_t)a << 32 | b : (uint64_t)b << 32 | a;
+		}
+	}
+
+	std::vector<uint32_t> MeshSimplifier::Simplify(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+		uint32_t targetIndexCount, float maxError, float* error)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		if (error)
+			*error = 0.0f;
+
+		uint32_t vertexCount = (uint32_t)positions.size();
+		if (vertexCount == 0 || indices.size() <= targetIndexCount)
+			return indices;
+
+		// Work in a unit box so maxError and the quadrics do not depend on the mesh's scale
+		glm::vec3 min = positions[0], max = positions[0];
+		for (const glm::vec3& position : positions)
+		{
+			min = glm::min(min, position);
+			max = glm::max(max, position);
+		}
+		float extent = std::max(max.x - min.x, std::max(max.y - min.y, max.z - min.z));
+		if (extent <= 0.0f)
+			return indices;
+
+		std::vector<glm::vec3> points(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+			points[i] = (positions[i] - min) / extent;
+
+		// Weld vertices that share a position onto the first of them, so seams do not read as borders
+		std::vector<uint32_t> weld(vertexCount);
+		{
+			std::vector<uint32_t> order(vertexCount);
+			for (uint32_t i = 0; i < vertexCount; i++)
+				order[i] = i;
+			auto less = [&](uint32_t a, uint32_t b)
+			{
+				const glm::vec3& pa = points[a];
+				const glm::vec3& pb = points[b];
+				if (pa.x != pb.x) return pa.x < pb.x;
+				if (pa.y != pb.y) return pa.y < pb.y;
+				if (pa.z != pb.z) return pa.z < pb.z;
+				return a < b;
+			};
+			std::sort(order.begin(), order.end(), less);
+
+			for (uint32_t i = 0; i < vertexCount; i++)
+				weld[order[i]] = i > 0 && points[order[i]] == points[order[i - 1]] ? weld[order[i - 1]] : order[i];
+		}
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			uint32_t a = weld[indices[i]], b = weld[indices[i + 1]], c = weld[indices[i + 2]];
+			if (a != b && b != c && c != a)
+			{
+				result.push_back(a);
+				result.push_back(b);
+				result.push_back(c);
+			}
+		}
+
+		// Every vertex starts with the planes of its triangles, weighted by area, and the planes standing on its
+		// border edges
+		std::vector<Quadric> quadrics(vertexCount);
+		{
+			std::unordered_map<uint64_t, uint32_t> edgeUses;
+			for (size_t i = 0; i < result.size(); i += 3)
+				for (uint32_t e = 0; e < 3; e++)
+					edgeUses[EdgeKey(result[i + e], result[i + (e + 1) % 3])]++;
+
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				const glm::vec3& p0 = points[result[i]];
+				glm::vec3 normal = glm::cross(points[result[i + 1]] - p0, points[result[i + 2]] - p0);
+				float length = glm::length(normal);
+				if (length == 0.0f)
+					continue;
+				normal /= length;
+
+				Quadric plane = Quadric::FromPlane(normal, -glm::dot(normal, p0), length * 0.5f);
+				for (uint32_t e = 0; e < 3; e++)
+					quadrics[result[i + e]].Add(plane);
+
+				for (uint32_t e = 0; e < 3; e++)
+				{
+					uint32_t a = result[i + e], b = result[i + (e + 1) % 3];
+					if (edgeUses[EdgeKey(a, b)] != 1)
+						continue;
+
+					glm::vec3 edge = points[b] - points[a];
+					glm::vec3 borderNormal = glm::cross(edge, normal);
+					float borderLength = glm::length(borderNormal);
+					if (borderLength == 0.0f)
+						continue;
+					borderNormal /= borderLength;
+
+					Quadric border = Quadric::FromPlane(borderNormal, -glm::dot(borderNormal, points[a]), glm::dot(edge, edge) * BorderWeight);
+					quadrics[a].Add(border);
+					quadrics[b].Add(border);
+				}
+			}
+		}
+
+		float errorLimit = maxError * maxError;
+		float resultError = 0.0f;
+
+		std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+		std::vector<uint32_t> vertexTriangles;
+		std::vector<uint64_t> edges;
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> collapseTo(vertexCount);
+		std::vector<uint8_t> border(vertexCount);
+		std::vector<uint8_t> locked(vertexCount);
+		std::unordered_set<uint64_t> borderEdges;
+
+		// Each pass collapses a set of edges whose one-rings do not overlap, so collapses never see each other's effects
+		while (result.size() > targetIndexCount)
+		{
+			uint32_t triangleCount = (uint32_t)result.size() / 3;
+
+			std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+			for (uint32_t index : result)
+				triangleOffsets[index + 1]++;
+			for (uint32_t v = 0; v < vertexCount; v++)
+				triangleOffsets[v + 1] += triangleOffsets[v];
+			vertexTriangles.resize(result.size());
+			{
+				std::vector<uint32_t> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+				for (uint32_t t = 0; t < triangleCount; t++)
+					for (uint32_t e = 0; e < 3; e++)
+						vertexTriangles[cursor[result[t * 3 + e]]++] = t;
+			}
+
+			edges.clear();
+			for (uint32_t t = 0; t < triangleCount; t++)
+				for (uint32_t e = 0; e < 3; e++)
+					edges.push_back(EdgeKey(result[t * 3 + e], result[t * 3 + (e + 1) % 3]));
+			std::sort(edges.begin(), edges.end());
+
+			// Edges used once are borders, edges used more than twice are non-manifold and pin both their vertices
+			std::fill(border.begin(), border.end(), 0);
+			borderEdges.clear();
+			size_t uniqueEdges = 0;
+			for (size_t i = 0; i < edges.size();)
+			{
+				size_t end = i + 1;
+				while (end < edges.size() && edges[end] == edges[i])
+					end++;
+
+				uint32_t a = (uint32_t)(edges[i] >> 32), b = (uint32_t)edges[i];
+				if (end - i != 2)
+				{
+					border[a] = border[b] = 1;
+					if (end - i == 1)
+						borderEdges.insert(edges[i]);
+				}
+				edges[uniqueEdges++] = edges[i];
+				i = end;
+			}
+			edges.resize(uniqueEdges);
+
+			auto canCollapse = [&](uint32_t from, uint32_t to)
+			{
+				return !border[from] || (border[to] && borderEdges.count(EdgeKey(from, to)));
+			};
+
+			collapses.clear();
+			for (uint64_t edge : edges)
+			{
+				uint32_t a = (uint32_t)(edge >> 32), b = (uint32_t)edge;
+
+				Quadric q = quadrics[a];
+				q.Add(quadrics[b]);
+
+				float costAB = canCollapse(a, b) ? q.Evaluate(points[b]) : FLT_MAX;
+				float costBA = canCollapse(b, a) ? q.Evaluate(points[a]) : FLT_MAX;
+				if (costAB == FLT_MAX && costBA == FLT_MAX)
+					continue;
+
+				collapses.push_back(costAB <= costBA ? Collapse{ a, b, costAB } : Collapse{ b, a, costBA });
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Cost < b.Cost; });
+
+			for (uint32_t v = 0; v < vertexCount; v++)
+				collapseTo[v] = v;
+			std::fill(locked.begin(), locked.end(), 0);
+
+			uint32_t trianglesToRemove = (triangleCount * 3 - targetIndexCount + 2) / 3;
+			uint32_t removed = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.Cost > errorLimit || removed >= trianglesToRemove)
+					break;
+				if (locked[collapse.From] || locked[collapse.To])
+					continue;
+
+				// Reject collapses that would fold a surviving triangle over
+				bool flips = false;
+				uint32_t collapsing = 0;
+				for (uint32_t i = triangleOffsets[collapse.From]; i < triangleOffsets[collapse.From + 1] && !flips; i++)
+				{
+					const uint32_t* triangle = &result[vertexTriangles[i] * 3];
+					if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+					{
+						collapsing++;
+						continue;
+					}
+
+					uint32_t corner = triangle[0] == collapse.From ? 0 : triangle[1] == collapse.From ? 1 : 2;
+					const glm::vec3& p1 = points[triangle[(corner + 1) % 3]];
+					const glm::vec3& p2 = points[triangle[(corner + 2) % 3]];
+					glm::vec3 before = glm::cross(p1 - points[collapse.From], p2 - points[collapse.From]);
+					glm::vec3 after = glm::cross(p1 - points[collapse.To], p2 - points[collapse.To]);
+					flips = glm::dot(before, after) <= 0.0f;
+				}
+				if (flips)
+					continue;
+
+				for (uint32_t i = triangleOffsets[collapse.From]; i < triangleOffsets[collapse.From + 1]; i++)
+				{
+					const uint32_t* triangle = &result[vertexTriangles[i] * 3];
+					locked[triangle[0]] = locked[triangle[1]] = locked[triangle[2]] = 1;
+				}
+
+				collapseTo[collapse.From] = collapse.To;
+				quadrics[collapse.To].Add(quadrics[collapse.From]);
+				resultError = std::max(resultError, collapse.Cost);
+				removed += collapsing;
+			}
+
+			if (removed == 0)
+				break;
+
+			size_t write = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				uint32_t a = collapseTo[result[i]], b = collapseTo[result[i + 1]], c = collapseTo[result[i + 2]];
+				if (a != b && b != c && c != a)
+				{
+					result[write++] = a;
+					result[write++] = b;
+					result[write++] = c;
+				}
+			}
+			result.resize(write);
+		}
+
+		if (error)
+			*error = std::sqrt(resultError) * extent;
+		return result;
+	}
+}
\ No newline at end of file
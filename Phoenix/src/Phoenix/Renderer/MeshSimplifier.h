@@ -0,0 +1,20 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace phx {
+	// Quadric error metric simplification by edge collapse. A vertex only ever collapses onto one of its neighbours,
+	// so simplified index lists still index the original vertices and every LOD of a mesh can share its vertex buffer.
+	// Vertices at the same position are welded, and borders only collapse along themselves
+	class MeshSimplifier
+	{
+	public:
+		// Collapses edges, cheapest first, until at most targetIndexCount indices are left or the next collapse would
+		// move the surface further than maxError, given as a fraction of the mesh's extent. error receives the
+		// largest deviation introduced, in mesh units
+		static std::vector<uint32_t> Simplify(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+			uint32_t targetIndexCount, float maxError, float* error = nullptr);
+	};
+}
\ No newline at end of file
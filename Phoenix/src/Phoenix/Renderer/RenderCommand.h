@@ -29,14 +29,34 @@ namespace phx {
 		{
 			s_RendererAPI->DrawIndexed(count);
 		}
-		static void DrawLines(const std::shared_ptr<VertexArray>& vertexArray, uint32_t vertexCount)
+		static void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0, uint32_t firstIndex = 0)
 		{
-			s_RendererAPI->DrawLines(vertexArray, vertexCount);
+			s_RendererAPI->DrawIndexedInstanced(vertexArray, indexCount, instanceCount, baseInstance, firstIndex);
+		}
+		static void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t firstDraw = 0)
+		{
+			s_RendererAPI->DrawIndexedIndirect(vertexArray, indirectBuffer, drawCount, firstDraw);
+		}
+		static void DrawLines(const std::shared_ptr<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0)
+		{
+			s_RendererAPI->DrawLines(vertexArray, vertexCount, firstVertex);
 		}
 		static void SetLineWidth(float width)
 		{
 			s_RendererAPI->SetLineWidth(width);
 		}
+		static void SetDepthRange(float nearDepth, float farDepth)
+		{
+			s_RendererAPI->SetDepthRange(nearDepth, farDepth);
+		}
+		static RendererAPI::StateStatistics GetStateStats()
+		{
+			return s_RendererAPI->GetStateStats();
+		}
+		static void ResetStateStats()
+		{
+			s_RendererAPI->ResetStateStats();
+		}
 	private:
 		static RendererAPI* s_RendererAPI;
 	};
@@ -0,0 +1,195 @@
+#include "phxpch.h"
+#include "RenderCommandBuffer.h"
+
+#include <mutex>
+
+namespace phx {
+	static constexpr size_t AllocationAlignment = alignof(std::max_align_t);
+
+	RenderCommandBuffer::~RenderCommandBuffer()
+	{
+		Reset();
+	}
+
+	void* RenderCommandBuffer::Allocate(size_t size)
+	{
+		size = (size + AllocationAlignment - 1) & ~(AllocationAlignment - 1);
+		if (size > PageSize)
+		{
+			m_LargeAllocations.push_back(Scope<uint8_t[]>(new uint8_t[size]));
+			return m_LargeAllocations.back().get();
+		}
+
+		if (m_Page < m_Pages.size() && m_PageOffset + size > PageSize)
+		{
+			m_Page++;
+			m_PageOffset = 0;
+		}
+		if (m_Page == m_Pages.size())
+			m_Pages.push_back(Scope<uint8_t[]>(new uint8_t[PageSize]));
+
+		void* memory = m_Pages[m_Page].get() + m_PageOffset;
+		m_PageOffset += size;
+		return memory;
+	}
+
+	void* RenderCommandBuffer::CopyData(const void* data, uint32_t size)
+	{
+		if (size == 0)
+			return nullptr;
+
+		void* copy = Allocate(size);
+		memcpy(copy, data, size);
+		return copy;
+	}
+
+	void RenderCommandBuffer::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		Record([=]() { RenderCommand::SetViewport(x, y, width, height); });
+	}
+
+	void RenderCommandBuffer::ClearColor(const glm::vec4& color)
+	{
+		Record([=]() { RenderCommand::ClearColor(color); });
+	}
+
+	void RenderCommandBuffer::Clear()
+	{
+		Record([]() { RenderCommand::Clear(); });
+	}
+
+	void RenderCommandBuffer::BindFramebuffer(const Ref<Framebuffer>& framebuffer)
+	{
+		Record([framebuffer]() { framebuffer->Bind(); });
+	}
+
+	void RenderCommandBuffer::UnbindFramebuffer(const Ref<Framebuffer>& framebuffer)
+	{
+		Record([framebuffer]() { framebuffer->Unbind(); });
+	}
+
+	void RenderCommandBuffer::BindShader(const Ref<Shader>& shader)
+	{
+		Record([shader]() { shader->Bind(); });
+	}
+
+	void RenderCommandBuffer::SetVertexBufferData(const Ref<VertexBuffer>& vertexBuffer, const void* data, uint32_t size, uint32_t offset)
+	{
+		const void* copy = CopyData(data, size);
+		Record([vertexBuffer, copy, size, offset]() { vertexBuffer->SetData(copy, size, offset); });
+	}
+
+	void RenderCommandBuffer::SetUniformBufferData(const Ref<UniformBuffer>& uniformBuffer, const void* data, uint32_t size, uint32_t offset)
+	{
+		const void* copy = CopyData(data, size);
+		Record([uniformBuffer, copy, size, offset]() { uniformBuffer->SetData(copy, size, offset); });
+	}
+
+	void RenderCommandBuffer::SetIndirectBufferData(const Ref<IndirectBuffer>& indirectBuffer, const void* data, uint32_t size, uint32_t offset)
+	{
+		const void* copy = CopyData(data, size);
+		Record([indirectBuffer, copy, size, offset]() { indirectBuffer->SetData(copy, size, offset); });
+	}
+
+	void RenderCommandBuffer::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount)
+	{
+		Record([vertexArray, indexCount]() { RenderCommand::DrawIndexed(vertexArray, indexCount); });
+	}
+
+	void RenderCommandBuffer::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance, uint32_t firstIndex)
+	{
+		Record([=]() { RenderCommand::DrawIndexedInstanced(vertexArray, indexCount, instanceCount, baseInstance, firstIndex); });
+	}
+
+	void RenderCommandBuffer::DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t firstDraw)
+	{
+		Record([=]() { RenderCommand::DrawIndexedIndirect(vertexArray, indirectBuffer, drawCount, firstDraw); });
+	}
+
+	void RenderCommandBuffer::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex)
+	{
+		Record([=]() { RenderCommand::DrawLines(vertexArray, vertexCount, firstVertex); });
+	}
+
+	void RenderCommandBuffer::SetLineWidth(float width)
+	{
+		Record([width]() { RenderCommand::SetLineWidth(width); });
+	}
+
+	void RenderCommandBuffer::Execute()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		for (CommandHeader* header = m_Head; header; header = header->Next)
+			header->Execute(header + 1);
+	}
+
+	void RenderCommandBuffer::Reset()
+	{
+		for (CommandHeader* header = m_Head; header; header = header->Next)
+			header->Destroy(header + 1);
+
+		m_Head = m_Tail = nullptr;
+		m_CommandCount = 0;
+		m_Page = 0;
+		m_PageOffset = 0;
+		m_LargeAllocations.clear();
+	}
+
+	struct RenderCommandQueueData
+	{
+		struct Submission
+		{
+			Ref<RenderCommandBuffer> Buffer;
+			uint64_t SortKey;
+		};
+
+		std::mutex Mutex;
+		std::vector<Submission> Pending;
+		std::vector<Submission> Replaying;
+
+		RenderCommandQueue::Statistics Stats;
+	};
+
+	static RenderCommandQueueData s_Queue;
+
+	void RenderCommandQueue::Submit(const Ref<RenderCommandBuffer>& buffer, uint64_t sortKey)
+	{
+		std::lock_guard lock(s_Queue.Mutex);
+		s_Queue.Pending.push_back({ buffer, sortKey });
+	}
+
+	void RenderCommandQueue::Flush()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		{
+			std::lock_guard lock(s_Queue.Mutex);
+			std::swap(s_Queue.Pending, s_Queue.Replaying);
+		}
+
+		std::stable_sort(s_Queue.Replaying.begin(), s_Queue.Replaying.end(),
+			[](const auto& a, const auto& b) { return a.SortKey < b.SortKey; });
+
+		// Commands may submit more buffers, which wait for the next flush
+		for (auto& submission : s_Queue.Replaying)
+		{
+			s_Queue.Stats.BufferCount++;
+			s_Queue.Stats.CommandCount += submission.Buffer->GetCommandCount();
+
+			submission.Buffer->Execute();
+			submission.Buffer->Reset();
+		}
+		s_Queue.Replaying.clear();
+	}
+
+	RenderCommandQueue::Statistics RenderCommandQueue::GetStats()
+	{
+		return s_Queue.Stats;
+	}
+
+	void RenderCommandQueue::ResetStats()
+	{
+		s_Queue.Stats = {};
+	}
+}
\ No newline at end of file
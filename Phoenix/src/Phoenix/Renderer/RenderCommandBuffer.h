@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Phoenix/Renderer/RenderCommand.h"
+#include "Phoenix/Renderer/Framebuffer.h"
+#include "Phoenix/Renderer/Shader.h"
+#include "Phoenix/Renderer/UniformBuffer.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace phx {
+	// Commands recorded now and replayed later, in order, on the thread that owns the graphics context. Recording
+	// never touches the GPU, so any thread can record into a buffer, but a buffer is recorded by one thread at a
+	// time. Commands and the data they upload are stored back to back in pages that Reset keeps for the next
+	// frame, so recording a frame allocates nothing once the pages are warm
+	class RenderCommandBuffer
+	{
+	public:
+		static constexpr uint32_t PageSize = 64 * 1024;
+
+		RenderCommandBuffer() = default;
+		~RenderCommandBuffer();
+
+		RenderCommandBuffer(const RenderCommandBuffer&) = delete;
+		RenderCommandBuffer& operator=(const RenderCommandBuffer&) = delete;
+
+		// Records any callable, moved into the buffer. It runs on the context thread, at its place in the buffer
+		template<typename Fn>
+		void Record(Fn&& fn)
+		{
+			using Command = std::decay_t<Fn>;
+			static_assert(alignof(Command) <= alignof(std::max_align_t), "Over-aligned render command");
+
+			CommandHeader* header = (CommandHeader*)Allocate(sizeof(CommandHeader) + sizeof(Command));
+			new (header + 1) Command(std::forward<Fn>(fn));
+			header->Execute = [](void* command) { (*(Command*)command)(); };
+			header->Destroy = [](void* command) { ((Command*)command)->~Command(); };
+			header->Next = nullptr;
+
+			if (m_Tail)
+				m_Tail->Next = header;
+			else
+				m_Head = header;
+			m_Tail = header;
+			m_CommandCount++;
+		}
+
+		// Copies data into the buffer, where it stays until Reset
+		void* CopyData(const void* data, uint32_t size);
+
+		void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+		void ClearColor(const glm::vec4& color);
+		void Clear();
+
+		void BindFramebuffer(const Ref<Framebuffer>& framebuffer);
+		void UnbindFramebuffer(const Ref<Framebuffer>& framebuffer);
+		void BindShader(const Ref<Shader>& shader);
+
+		// The data is copied when recorded
+		void SetVertexBufferData(const Ref<VertexBuffer>& vertexBuffer, const void* data, uint32_t size, uint32_t offset = 0);
+		void SetUniformBufferData(const Ref<UniformBuffer>& uniformBuffer, const void* data, uint32_t size, uint32_t offset = 0);
+		void SetIndirectBufferData(const Ref<IndirectBuffer>& indirectBuffer, const void* data, uint32_t size, uint32_t offset = 0);
+
+		void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0);
+		void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0, uint32_t firstIndex = 0);
+		void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t firstDraw = 0);
+		void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0);
+		void SetLineWidth(float width);
+
+		// Runs every command in recording order. Must be called on the context thread; the commands stay recorded
+		void Execute();
+		// Destroys the commands and their data, keeping the pages
+		void Reset();
+
+		uint32_t GetCommandCount() const { return m_CommandCount; }
+		bool IsEmpty() const { return m_CommandCount == 0; }
+	private:
+		struct alignas(std::max_align_t) CommandHeader
+		{
+			void (*Execute)(void* command);
+			void (*Destroy)(void* command);
+			CommandHeader* Next;
+		};
+
+		void* Allocate(size_t size);
+	private:
+		std::vector<Scope<uint8_t[]>> m_Pages;
+		std::vector<Scope<uint8_t[]>> m_LargeAllocations; // Anything bigger than a page, freed on Reset
+		uint32_t m_Page = 0;
+		size_t m_PageOffset = 0;
+
+		CommandHeader* m_Head = nullptr;
+		CommandHeader* m_Tail = nullptr;
+		uint32_t m_CommandCount = 0;
+	};
+
+	// Buffers waiting to be replayed on the context thread. Any thread may submit; Flush replays them by ascending
+	// sort key, buffers with equal keys in the order they were submitted, and resets them. Buffers recorded in
+	// parallel are given their index as key so the replay order does not depend on which job finished first
+	class RenderCommandQueue
+	{
+	public:
+		static void Submit(const Ref<RenderCommandBuffer>& buffer, uint64_t sortKey = 0);
+
+		// Must be called on the context thread
+		static void Flush();
+
+		struct Statistics
+		{
+			uint32_t BufferCount = 0;
+			uint32_t CommandCount = 0;
+		};
+		static Statistics GetStats();
+		static void ResetStats();
+	};
+}
\ No newline at end of file
@@ -3,8 +3,7 @@
 
 #include "Phoenix/Renderer/Renderer2D.h"
 #include "Phoenix/Renderer/Renderer3D.h"
-
-#include "Platform/OpenGL/OpenGLShader.h"
+#include "Phoenix/Renderer/GPUProfiler.h"
 
 namespace phx {
 	Renderer::SceneData* Renderer::m_SceneData = new Renderer::SceneData;
@@ -14,6 +13,7 @@ namespace phx {
 		PHX_PROFILE_FUNCTION();
 
 		RenderCommand::Init();
+		GPUProfiler::Init();
 		Renderer2D::Init();
 		Renderer3D::Init();
 	}
@@ -32,9 +32,14 @@ namespace phx {
 	}
 	void Renderer::Submit(const std::shared_ptr<Shader>& shader, const std::shared_ptr<VertexArray>& vertexArray, const glm::mat4& tranform)
 	{
+		// The shader caches its own handles, so they can never outlive it and be mistaken for those of a new shader
+		// given the same renderer ID. The names are built once rather than on every lookup
+		static const std::string ViewProjectionName = "u_ViewProjection";
+		static const std::string TransformName = "u_Transform";
+
 		shader->Bind();
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_ViewProjection", m_SceneData->ViewProjectionMatrix);
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_Transform", tranform);
+		shader->SetMat4(shader->GetUniformHandle(ViewProjectionName), m_SceneData->ViewProjectionMatrix);
+		shader->SetMat4(shader->GetUniformHandle(TransformName), tranform);
 
 		vertexArray->Bind();
 		RenderCommand::DrawIndexed(vertexArray);
@@ -5,81 +5,232 @@
 #include "Phoenix/Renderer/Shader.h"
 #include "Phoenix/Renderer/UniformBuffer.h"
 #include "Phoenix/Renderer/RenderCommand.h"
+#include "Phoenix/Renderer/GPUProfiler.h"
+#include "Phoenix/Threading/JobSystem.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <limits>
 
 namespace phx
 {
-	struct QuadVertex
+	// Quads and circles are drawn as instances of a shared unit quad. Each instance stores the
+	// affine columns of its transform so the vertex shader can place the four corners itself.
+	// Everything else is quantized: colors are RGBA8, so they are clamped to [0, 1]
+	struct QuadInstance
 	{
-		glm::vec3 Position;
-		glm::vec4 Color;
-		glm::vec2 TexCoord;
-		float TexIndex;
-		float TilingFactor;
+		glm::vec3 Right;
+		glm::vec3 Up;
+		glm::vec3 Origin;
+		uint32_t Color; // RGBA8
+		uint32_t TexRectMin; // unorm16 min UV
+		uint32_t TexRectMax; // unorm16 max UV
+		uint16_t TexIndex;
+		uint16_t TexLayer; // Only used when TexIndex refers to a texture array
+		uint32_t TilingFactor; // Half float, upper half unused
+
+#ifdef PHX_RENDERER_ENTITY_ID
+		int EntityID;
+#endif
+	};
+
+	struct CircleInstance
+	{
+		glm::vec3 Right;
+		glm::vec3 Up;
+		glm::vec3 Origin;
+		uint32_t Color; // RGBA8
+		uint32_t ThicknessFade; // Half floats
 
-		// Editor-only
+#ifdef PHX_RENDERER_ENTITY_ID
 		int EntityID;
+#endif
 	};
 
-	struct CircleVertex
+	static void WriteQuadInstance(QuadInstance& instance, const glm::vec3& right, const glm::vec3& up, const glm::vec3& origin, const glm::vec4& color, float textureIndex, float textureLayer, float tilingFactor, int entityID)
 	{
-		glm::vec3 WorldPosition;
-		glm::vec3 LocalPosition;
-		glm::vec4 Color;
-		float Thickness;
-		float Fade;
+		static const uint32_t TexRectMin = glm::packUnorm2x16(glm::vec2(0.0f));
+		static const uint32_t TexRectMax = glm::packUnorm2x16(glm::vec2(1.0f));
+
+		instance.Right = right;
+		instance.Up = up;
+		instance.Origin = origin;
+		instance.Color = glm::packUnorm4x8(color);
+		instance.TexRectMin = TexRectMin;
+		instance.TexRectMax = TexRectMax;
+		instance.TexIndex = (uint16_t)textureIndex;
+		instance.TexLayer = (uint16_t)textureLayer;
+		instance.TilingFactor = glm::packHalf2x16({ tilingFactor, 0.0f });
+#ifdef PHX_RENDERER_ENTITY_ID
+		instance.EntityID = entityID;
+#endif
+	}
+
+	static void WriteCircleInstance(CircleInstance& instance, const glm::vec3& right, const glm::vec3& up, const glm::vec3& origin, const glm::vec4& color, float thickness, float fade, int entityID)
+	{
+		instance.Right = right;
+		instance.Up = up;
+		instance.Origin = origin;
+		instance.Color = glm::packUnorm4x8(color);
+		instance.ThicknessFade = glm::packHalf2x16({ thickness, fade });
+#ifdef PHX_RENDERER_ENTITY_ID
+		instance.EntityID = entityID;
+#endif
+	}
+
+	// A quad, circle or particle pool recorded in sorted submission mode, emitted at EndScene
+	struct SortedDraw
+	{
+		enum class Primitive : uint8_t { Quad = 0, Circle, Particles };
 
-		// Editor-only
+		glm::vec3 Right;
+		glm::vec3 Up;
+		glm::vec3 Origin;
+		glm::vec4 Color;
+		uint32_t TextureIndex; // Into the per-scene texture table, 0 = untextured
+		float TilingFactor; // Thickness for circles
+		union
+		{
+			float Fade;
+			uint32_t PoolIndex; // Into the particle pools of its list
+		};
 		int EntityID;
+		Primitive Type;
+	};
+
+	struct SortEntry
+	{
+		uint64_t Key;
+		uint32_t Index; // Into the draws of its list
+		uint32_t List;
+	};
+
+	struct SortedDrawList
+	{
+		uint32_t ListIndex = 0;
+		std::vector<SortedDraw> Draws;
+		std::vector<SortEntry> Entries;
+		std::vector<Ref<Texture2D>> Textures; // Keeps recorded textures alive until EndScene, [0] = none
+		std::unordered_map<uint32_t, uint32_t> TextureLookup; // Renderer ID -> index in Textures
+		std::vector<const ParticlePool*> Pools;
+
+		void Clear()
+		{
+			Draws.clear();
+			Entries.clear();
+			Textures.resize(1);
+			TextureLookup.clear();
+			Pools.clear();
+		}
 	};
 
 	struct LineVertex
 	{
 		glm::vec3 Position;
-		glm::vec4 Color;
- 
-		// Editor-only
+		uint32_t Color; // RGBA8
+
+#ifdef PHX_RENDERER_ENTITY_ID
 		int EntityID;
+#endif
 	};
 
 	struct Renderer2DData
 	{
 		static const uint32_t MaxQuads = 20000;
 		static const uint32_t MaxVertices = MaxQuads * 4;
-		static const uint32_t MaxIndices = MaxQuads * 6;
-		static const uint32_t MaxTextureSlots = 32; // TODO: RenderCaps
+		// Full batches each streaming ring holds. The GPU may still be reading the last few frames, so the quad
+		// ring covers about three frames of 200k sprites; circles and lines are rarely drawn in those numbers
+		static const uint32_t QuadStreamingBatches = 32;
+		static const uint32_t StreamingBatches = 4;
+		static const uint32_t MaxTextureSlots = 24; // TODO: RenderCaps
+		static const uint32_t MaxTextureArraySlots = 8; // Bound after the plain slots
+		static const uint32_t MaxTextureArraySize = 2048; // Larger textures always use plain slots
+		static const uint32_t InitialTextureArrayLayers = 4;
+		static const uint32_t MaxTextureArrayLayers = 256;
+
+		// The depth range is split into bands, farthest first. Depth orders draws within a band but never across
+		// bands: tilemaps and static batches sit beneath every sorting layer, each sorting layer gets one, and
+		// everything drawn unsorted goes in the nearest
+		static const uint32_t TilemapDepthBand = 0;
+		static const uint32_t StaticDepthBand = 1;
+		static const uint32_t FirstLayerDepthBand = 2;
+		static const uint32_t UnsortedDepthBand = FirstLayerDepthBand + 256;
+		static const uint32_t DepthBandCount = UnsortedDepthBand + 1;
+
+		Ref<VertexBuffer> UnitQuadVertexBuffer;
+		Ref<IndexBuffer> UnitQuadIndexBuffer;
 
 		Ref<VertexArray> QuadVertexArray;
-		Ref<VertexBuffer> QuadVertexBuffer;
+		Ref<StreamingVertexBuffer> QuadInstanceBuffer;
 		Ref<Shader> QuadShader;
 		Ref<Texture2D> WhiteTexture;
 
 		Ref<VertexArray> CircleVertexArray;
-		Ref<VertexBuffer> CircleVertexBuffer;
+		Ref<StreamingVertexBuffer> CircleInstanceBuffer;
 		Ref<Shader> CircleShader;
 
 		Ref<VertexArray> LineVertexArray;
-		Ref<VertexBuffer> LineVertexBuffer;
+		Ref<StreamingVertexBuffer> LineVertexBuffer;
 		Ref<Shader> LineShader;
 
-		uint32_t QuadIndexCount = 0;
-		QuadVertex* QuadVertexBufferBase = nullptr;
-		QuadVertex* QuadVertexBufferPtr = nullptr;
+		Ref<VertexArray> TilemapVertexArray;
+		Ref<Shader> TilemapShader;
+
+		// The buffer bases point straight into the persistently mapped region of the current batch
+		uint32_t QuadInstanceCount = 0;
+		QuadInstance* QuadInstanceBufferBase = nullptr;
+		QuadInstance* QuadInstanceBufferPtr = nullptr;
 
-		uint32_t CircleIndexCount = 0;
-		CircleVertex* CircleVertexBufferBase = nullptr;
-		CircleVertex* CircleVertexBufferPtr = nullptr;
+		uint32_t CircleInstanceCount = 0;
+		CircleInstance* CircleInstanceBufferBase = nullptr;
+		CircleInstance* CircleInstanceBufferPtr = nullptr;
 
 		uint32_t LineVertexCount = 0;
 		LineVertex* LineVertexBufferBase = nullptr;
 		LineVertex* LineVertexBufferPtr = nullptr;
 
 		float LineWidth = 2.0f;
+		uint32_t DepthBand = Renderer2DData::UnsortedDepthBand;
 
 		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
 		uint32_t TextureSlotIndex = 1; // 0 = white texture
+		std::unordered_map<uint32_t, uint32_t> TextureSlotLookup; // Renderer ID -> slot in the current batch
+
+		// Same-sized textures are copied into layers of a shared array page, so a whole page costs a single binding.
+		// Pages and layers persist across frames, a layer is copied again when its texture's data changes.
+		struct TextureArrayPage
+		{
+			Ref<Texture2DArray> Array;
+			uint32_t LayerCount = 0; // Layers handed out so far
+			std::vector<uint32_t> FreeLayers;
+			int32_t BatchSlot = -1;
+		};
+
+		struct TextureArrayEntry
+		{
+			std::weak_ptr<Texture2D> Texture; // Detects renderer IDs recycled by a new texture
+			uint32_t Page;
+			uint32_t Layer;
+			uint32_t Version; // Of the texture when the layer was copied
+		};
+
+		std::vector<TextureArrayPage> TextureArrayPages;
+		std::unordered_map<uint64_t, uint32_t> TextureArrayPageLookup; // (width << 32 | height) -> page
+		std::unordered_map<uint32_t, TextureArrayEntry> TextureArrayEntries; // Renderer ID -> layer
+
+		std::array<uint32_t, MaxTextureArraySlots> TextureArraySlots; // Page bound to each array slot
+		uint32_t TextureArraySlotIndex = 0;
+
+		Renderer2D::TextureBindingMode BindingMode = Renderer2D::TextureBindingMode::TextureArrays;
+
+		Renderer2D::SubmissionMode Submission = Renderer2D::SubmissionMode::Sorted;
+		std::vector<Scope<Renderer2D::DrawList>> DrawLists; // One per JobSystem thread, [0] is used by the Draw* calls
+		std::vector<SortedDrawList*> SortedLists; // Storage of each draw list
+		std::vector<SortEntry> SortEntries; // Entries of every list, merged at EndScene
+		std::vector<SortEntry> SortScratch;
+		std::vector<glm::vec2> ResolvedTextures; // Texture index and layer of each quad in the run being emitted
 
 		glm::vec4 QuadVertexPositions[4];
 
@@ -91,77 +242,126 @@ namespace phx
 		};
 		CameraData CameraBuffer;
 		Ref<UniformBuffer> CameraUniformBuffer;
+
+		// Layout matches the std140 Tilemap block of the tilemap shader
+		struct TilemapData
+		{
+			glm::mat4 ChunkTransform; // Unit quad -> chunk
+			glm::vec4 Color;
+			glm::ivec2 AtlasGrid;
+			int ChunkSize;
+			int EntityID;
+		};
+		TilemapData TilemapBuffer;
+		Ref<UniformBuffer> TilemapUniformBuffer;
+
+		Math::AABB2D ViewBounds = { glm::vec2(std::numeric_limits<float>::lowest()), glm::vec2(std::numeric_limits<float>::max()) };
 	};
 
 	static Renderer2DData s_Data;
 
-	void Renderer2D::Init()
+	struct StaticBatchData
 	{
-		PHX_PROFILE_FUNCTION();
-		
-		// Quads
-		s_Data.QuadVertexArray = VertexArray::Create();
-
-		s_Data.QuadVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(QuadVertex));
-		s_Data.QuadVertexBuffer->SetLayout({
-			{ ShaderDataType::vec3, "a_Position"      },
-			{ ShaderDataType::vec4, "a_Color"         },
-			{ ShaderDataType::vec2, "a_TexCoord"      },
-			{ ShaderDataType::Float, "a_TexIndex"     },
-			{ ShaderDataType::Float, "a_TilingFactor" },
-			{ ShaderDataType::Int, "a_EntityID"       }
-		});
-		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.QuadVertexBuffer);
+		// Created at the first draw and recreated whenever the batch outgrows it
+		Ref<VertexArray> QuadVertexArray;
+		Ref<VertexBuffer> InstanceBuffer;
+		uint32_t Capacity = 0;
 
-		s_Data.QuadVertexBufferBase = new QuadVertex[s_Data.MaxVertices];
+		std::vector<QuadInstance> Instances; // CPU copy of the instance buffer
+		uint32_t DirtyBegin = 0, DirtyEnd = 0; // Instances to upload at the next draw
 
-		uint32_t* quadIndices = new uint32_t[s_Data.MaxIndices];
+		std::array<Ref<Texture2D>, Renderer2DData::MaxTextureSlots> Textures; // [0] = white texture
+		std::array<uint32_t, Renderer2DData::MaxTextureSlots> TextureRefs{};
+		std::unordered_map<uint32_t, uint32_t> TextureLookup; // Renderer ID -> slot
 
-		uint32_t offset = 0;
-		for (uint32_t i = 0; i < s_Data.MaxIndices; i += 6)
+		void MarkDirty(uint32_t slot)
 		{
-			quadIndices[i + 0] = offset + 0;
-			quadIndices[i + 1] = offset + 1;
-			quadIndices[i + 2] = offset + 2;
+			if (DirtyBegin == DirtyEnd)
+			{
+				DirtyBegin = slot;
+				DirtyEnd = slot + 1;
+			}
+			else
+			{
+				DirtyBegin = std::min(DirtyBegin, slot);
+				DirtyEnd = std::max(DirtyEnd, slot + 1);
+			}
+		}
+	};
 
-			quadIndices[i + 3] = offset + 2;
-			quadIndices[i + 4] = offset + 3;
-			quadIndices[i + 5] = offset + 0;
+	void Renderer2D::Init()
+	{
+		PHX_PROFILE_FUNCTION();
+		
+		// Unit quad shared by the quad and circle instances
+		float unitQuadVertices[] = {
+			-0.5f, -0.5f,
+			 0.5f, -0.5f,
+			 0.5f,  0.5f,
+			-0.5f,  0.5f
+		};
+		s_Data.UnitQuadVertexBuffer = VertexBuffer::Create(unitQuadVertices, sizeof(unitQuadVertices));
+		s_Data.UnitQuadVertexBuffer->SetLayout({
+			{ ShaderDataType::vec2, "a_Position" }
+		});
 
-			offset += 4;
-		}
+		uint32_t unitQuadIndices[] = { 0, 1, 2, 2, 3, 0 };
+		s_Data.UnitQuadIndexBuffer = IndexBuffer::Create(unitQuadIndices, 6);
 
-		Ref<IndexBuffer> quadIB = IndexBuffer::Create(quadIndices, s_Data.MaxIndices);
-		s_Data.QuadVertexArray->SetIndexBuffer(quadIB);
-		delete[] quadIndices;
+		// Quads
+		s_Data.QuadVertexArray = VertexArray::Create();
+		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.UnitQuadVertexBuffer);
+
+		s_Data.QuadInstanceBuffer = StreamingVertexBuffer::Create(s_Data.MaxQuads * sizeof(QuadInstance), s_Data.QuadStreamingBatches);
+		s_Data.QuadInstanceBuffer->SetLayout({
+			{ ShaderDataType::vec3, "a_Right"         },
+			{ ShaderDataType::vec3, "a_Up"            },
+			{ ShaderDataType::vec3, "a_Origin"        },
+			{ ShaderDataType::ubyte4, "a_Color", true    },
+			{ ShaderDataType::ushort4, "a_TexRect", true },
+			{ ShaderDataType::ushort2, "a_TexIndex"      },
+			{ ShaderDataType::half2, "a_TilingFactor"    },
+#ifdef PHX_RENDERER_ENTITY_ID
+			{ ShaderDataType::Int, "a_EntityID"          }
+#endif
+		});
+		s_Data.QuadVertexArray->AddInstanceBuffer(s_Data.QuadInstanceBuffer);
+		s_Data.QuadVertexArray->SetIndexBuffer(s_Data.UnitQuadIndexBuffer);
 
 		// Circles
 		s_Data.CircleVertexArray = VertexArray::Create();
-
-		s_Data.CircleVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(CircleVertex));
-		s_Data.CircleVertexBuffer->SetLayout({
-			{ ShaderDataType::vec3,   "a_WorldPosition" },
-			{ ShaderDataType::vec3,   "a_LocalPosition" },
-			{ ShaderDataType::vec4,   "a_Color"         },
-			{ ShaderDataType::Float,  "a_Thickness"     },
-			{ ShaderDataType::Float,  "a_Fade"          },
-			{ ShaderDataType::Int,    "a_EntityID"      }
+		s_Data.CircleVertexArray->AddVertexBuffer(s_Data.UnitQuadVertexBuffer);
+
+		s_Data.CircleInstanceBuffer = StreamingVertexBuffer::Create(s_Data.MaxQuads * sizeof(CircleInstance), s_Data.StreamingBatches);
+		s_Data.CircleInstanceBuffer->SetLayout({
+			{ ShaderDataType::vec3,   "a_Right"     },
+			{ ShaderDataType::vec3,   "a_Up"        },
+			{ ShaderDataType::vec3,   "a_Origin"    },
+			{ ShaderDataType::ubyte4, "a_Color", true },
+			{ ShaderDataType::half2,  "a_ThicknessFade" },
+#ifdef PHX_RENDERER_ENTITY_ID
+			{ ShaderDataType::Int,    "a_EntityID"  }
+#endif
 			});
-		s_Data.CircleVertexArray->AddVertexBuffer(s_Data.CircleVertexBuffer);
-		s_Data.CircleVertexArray->SetIndexBuffer(quadIB); // Use quad IB
-		s_Data.CircleVertexBufferBase = new CircleVertex[s_Data.MaxVertices];
+		s_Data.CircleVertexArray->AddInstanceBuffer(s_Data.CircleInstanceBuffer);
+		s_Data.CircleVertexArray->SetIndexBuffer(s_Data.UnitQuadIndexBuffer);
 
 		// Lines
 		s_Data.LineVertexArray = VertexArray::Create();
 
-		s_Data.LineVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(LineVertex));
+		s_Data.LineVertexBuffer = StreamingVertexBuffer::Create(s_Data.MaxVertices * sizeof(LineVertex), s_Data.StreamingBatches);
 		s_Data.LineVertexBuffer->SetLayout({
-			{ ShaderDataType::vec3, "a_Position"        },
-			{ ShaderDataType::vec4, "a_Color"           },
-			{ ShaderDataType::Int,  "a_EntityID"        }
+			{ ShaderDataType::vec3,   "a_Position"      },
+			{ ShaderDataType::ubyte4, "a_Color", true   },
+#ifdef PHX_RENDERER_ENTITY_ID
+			{ ShaderDataType::Int,    "a_EntityID"      }
+#endif
 			});
 		s_Data.LineVertexArray->AddVertexBuffer(s_Data.LineVertexBuffer);
-		s_Data.LineVertexBufferBase = new LineVertex[s_Data.MaxVertices];
+
+		s_Data.TilemapVertexArray = VertexArray::Create();
+		s_Data.TilemapVertexArray->AddVertexBuffer(s_Data.UnitQuadVertexBuffer);
+		s_Data.TilemapVertexArray->SetIndexBuffer(s_Data.UnitQuadIndexBuffer);
 		
 		// White texture creation
 		s_Data.WhiteTexture = Texture2D::Create(1, 1);
@@ -176,9 +376,18 @@ namespace phx
 		s_Data.QuadShader = Shader::Create("Renderer2D_Quad", "assets/shaders/Renderer2D_Quad.vert", "assets/shaders/Renderer2D_Quad.frag");
 		s_Data.CircleShader = Shader::Create("Renderer2D_Circle", "assets/shaders/Renderer2D_Circle.vert", "assets/shaders/Renderer2D_Circle.frag");
 		s_Data.LineShader = Shader::Create("Renderer2D_Line", "assets/shaders/Renderer2D_Line.vert", "assets/shaders/Renderer2D_Line.frag");
+		s_Data.TilemapShader = Shader::Create("Renderer2D_Tilemap", "assets/shaders/Renderer2D_Tilemap.vert", "assets/shaders/Renderer2D_Tilemap.frag");
 
 		// Set all texture slots to 0
 		s_Data.TextureSlots[0] = s_Data.WhiteTexture;
+		uint32_t threadCount = JobSystem::GetThreadCount();
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			auto& drawList = s_Data.DrawLists.emplace_back(CreateScope<DrawList>());
+			drawList->m_List->ListIndex = i;
+			s_Data.SortedLists.push_back(drawList->m_List.get());
+		}
+		s_Data.ResolvedTextures.resize(s_Data.MaxQuads);
 
 		s_Data.QuadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
 		s_Data.QuadVertexPositions[1] = { 0.5f, -0.5f, 0.0f, 1.0f  };
@@ -186,23 +395,71 @@ namespace phx
 		s_Data.QuadVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
 
 		s_Data.CameraUniformBuffer = UniformBuffer::Create(sizeof(Renderer2DData::CameraData), 0);
+		s_Data.TilemapUniformBuffer = UniformBuffer::Create(sizeof(Renderer2DData::TilemapData), 1);
 	}
 
 	void Renderer2D::Shutdown()
 	{
 		PHX_PROFILE_FUNCTION();
 
-		delete[] s_Data.QuadVertexBufferBase;
+		s_Data.TextureArrayEntries.clear();
+		s_Data.TextureArrayPageLookup.clear();
+		s_Data.TextureArrayPages.clear();
+		s_Data.SortedLists.clear();
+		s_Data.DrawLists.clear();
+
+		// The mapped storage is owned by the streaming buffers
+		s_Data.QuadInstanceBufferBase = nullptr;
+		s_Data.CircleInstanceBufferBase = nullptr;
+		s_Data.LineVertexBufferBase = nullptr;
+	}
+
+	// Bounds of the NDC cube corners in world space. Falls back to unbounded when a corner lies behind the eye
+	static Math::AABB2D ComputeViewBounds(const glm::mat4& viewProjection)
+	{
+		glm::mat4 inverseViewProjection = glm::inverse(viewProjection);
+
+		Math::AABB2D bounds = { glm::vec2(std::numeric_limits<float>::max()), glm::vec2(std::numeric_limits<float>::lowest()) };
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			glm::vec4 ndc = { (i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f };
+			glm::vec4 corner = inverseViewProjection * ndc;
+			if (corner.w <= 0.0f)
+				return { glm::vec2(std::numeric_limits<float>::lowest()), glm::vec2(std::numeric_limits<float>::max()) };
+
+			glm::vec2 position = glm::vec2(corner) / corner.w;
+			bounds.Min = glm::min(bounds.Min, position);
+			bounds.Max = glm::max(bounds.Max, position);
+		}
+		return bounds;
+	}
+
+	static SortedDrawList& GetMainDrawList()
+	{
+		return *s_Data.SortedLists[0];
+	}
+
+	static bool HasSortedDraws()
+	{
+		for (const SortedDrawList* list : s_Data.SortedLists)
+		{
+			if (!list->Entries.empty())
+				return true;
+		}
+		return false;
 	}
 
 	void Renderer2D::BeginScene(const OrthographicCamera& camera)
 	{
 		PHX_PROFILE_FUNCTION();
 
-		s_Data.QuadShader->Bind();
-		s_Data.QuadShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+		s_Data.CameraBuffer.ViewProjection = camera.GetViewProjectionMatrix();
+		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
+		s_Data.ViewBounds = ComputeViewBounds(s_Data.CameraBuffer.ViewProjection);
 
+		GPUProfiler::BeginScope("Renderer2D Scene");
 		StartBatch();
+		SetDepthBand(Renderer2DData::UnsortedDepthBand);
 	}
 
 	void Renderer2D::BeginScene(const Camera& camera, const glm::mat4& transform)
@@ -211,8 +468,11 @@ namespace phx
 
 		s_Data.CameraBuffer.ViewProjection = camera.GetProjection() * glm::inverse(transform);
 		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
+		s_Data.ViewBounds = ComputeViewBounds(s_Data.CameraBuffer.ViewProjection);
 
+		GPUProfiler::BeginScope("Renderer2D Scene");
 		StartBatch();
+		SetDepthBand(Renderer2DData::UnsortedDepthBand);
 	}
 
 	void Renderer2D::BeginScene(const EditorCamera& camera)
@@ -221,65 +481,94 @@ namespace phx
 
 		s_Data.CameraBuffer.ViewProjection = camera.GetViewProjection();
 		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
+		s_Data.ViewBounds = ComputeViewBounds(s_Data.CameraBuffer.ViewProjection);
 
+		GPUProfiler::BeginScope("Renderer2D Scene");
 		StartBatch();
+		SetDepthBand(Renderer2DData::UnsortedDepthBand);
 	}
 
 	void Renderer2D::EndScene()
 	{
 		PHX_PROFILE_FUNCTION();
 
+		if (HasSortedDraws())
+			EmitSortedDraws();
+
 		Flush();
+		GPUProfiler::EndScope();
+
+		// Leave the full range to whatever draws after the scene
+		RenderCommand::SetDepthRange(0.0f, 1.0f);
 	}
 
 	void Renderer2D::StartBatch()
 	{
-		s_Data.QuadIndexCount = 0;
-		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
+		s_Data.QuadInstanceCount = 0;
+		s_Data.QuadInstanceBufferBase = (QuadInstance*)s_Data.QuadInstanceBuffer->Map();
+		s_Data.QuadInstanceBufferPtr = s_Data.QuadInstanceBufferBase;
 
-		s_Data.CircleIndexCount = 0;
-		s_Data.CircleVertexBufferPtr = s_Data.CircleVertexBufferBase;
+		s_Data.CircleInstanceCount = 0;
+		s_Data.CircleInstanceBufferBase = (CircleInstance*)s_Data.CircleInstanceBuffer->Map();
+		s_Data.CircleInstanceBufferPtr = s_Data.CircleInstanceBufferBase;
 
 		s_Data.LineVertexCount = 0;
+		s_Data.LineVertexBufferBase = (LineVertex*)s_Data.LineVertexBuffer->Map();
 		s_Data.LineVertexBufferPtr = s_Data.LineVertexBufferBase;
 
 		s_Data.TextureSlotIndex = 1;
+		s_Data.TextureSlotLookup.clear();
+
+		for (uint32_t i = 0; i < s_Data.TextureArraySlotIndex; i++)
+			s_Data.TextureArrayPages[s_Data.TextureArraySlots[i]].BatchSlot = -1;
+		s_Data.TextureArraySlotIndex = 0;
 	}
 
 	void Renderer2D::Flush()
 	{
-		if (s_Data.QuadIndexCount)
-		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.QuadVertexBufferPtr - (uint8_t*)s_Data.QuadVertexBufferBase);
-			s_Data.QuadVertexBuffer->SetData(s_Data.QuadVertexBufferBase, dataSize);
+		// Flushes with nothing batched are common, at EndScene and before anything drawn immediately, and timing them
+		// would only spend timestamps on empty scopes
+		if (!s_Data.QuadInstanceCount && !s_Data.CircleInstanceCount && !s_Data.LineVertexCount)
+			return;
 
+		GPUProfileScope gpuScope("Renderer2D Flush");
+
+		// Instance data was written straight into the mapped regions, so drawing only needs to
+		// point the fetch at the current region and fence it before moving on
+		if (s_Data.QuadInstanceCount)
+		{
 			// Bind textures
 			for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
 				s_Data.TextureSlots[i]->Bind(i);
+			for (uint32_t i = 0; i < s_Data.TextureArraySlotIndex; i++)
+				s_Data.TextureArrayPages[s_Data.TextureArraySlots[i]].Array->Bind(Renderer2DData::MaxTextureSlots + i);
+
+			uint32_t baseInstance = s_Data.QuadInstanceBuffer->GetRegionOffset() / sizeof(QuadInstance);
 
 			s_Data.QuadShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.QuadVertexArray, s_Data.QuadIndexCount);
+			RenderCommand::DrawIndexedInstanced(s_Data.QuadVertexArray, 6, s_Data.QuadInstanceCount, baseInstance);
+			s_Data.QuadInstanceBuffer->Advance(s_Data.QuadInstanceCount * sizeof(QuadInstance));
 			s_Data.Stats.DrawCalls++;
 		}
 
-		if (s_Data.CircleIndexCount)
+		if (s_Data.CircleInstanceCount)
 		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.CircleVertexBufferPtr - (uint8_t*)s_Data.CircleVertexBufferBase);
-			s_Data.CircleVertexBuffer->SetData(s_Data.CircleVertexBufferBase, dataSize);
+			uint32_t baseInstance = s_Data.CircleInstanceBuffer->GetRegionOffset() / sizeof(CircleInstance);
 
 			s_Data.CircleShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.CircleVertexArray, s_Data.CircleIndexCount);
+			RenderCommand::DrawIndexedInstanced(s_Data.CircleVertexArray, 6, s_Data.CircleInstanceCount, baseInstance);
+			s_Data.CircleInstanceBuffer->Advance(s_Data.CircleInstanceCount * sizeof(CircleInstance));
 			s_Data.Stats.DrawCalls++;
 		}
 
 		if (s_Data.LineVertexCount)
 		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.LineVertexBufferPtr - (uint8_t*)s_Data.LineVertexBufferBase);
-			s_Data.LineVertexBuffer->SetData(s_Data.LineVertexBufferBase, dataSize);
+			uint32_t firstVertex = s_Data.LineVertexBuffer->GetRegionOffset() / sizeof(LineVertex);
 
 			s_Data.LineShader->Bind();
 			RenderCommand::SetLineWidth(s_Data.LineWidth);
-			RenderCommand::DrawLines(s_Data.LineVertexArray, s_Data.LineVertexCount);
+			RenderCommand::DrawLines(s_Data.LineVertexArray, s_Data.LineVertexCount, firstVertex);
+			s_Data.LineVertexBuffer->Advance(s_Data.LineVertexCount * sizeof(LineVertex));
 			s_Data.Stats.DrawCalls++;
 		}
 	}
@@ -290,6 +579,373 @@ namespace phx
 		StartBatch();
 	}
 
+	void Renderer2D::SetDepthBand(uint32_t band)
+	{
+		// The range applies when a batch is drawn, so whatever was batched under the previous band goes first
+		if (s_Data.QuadInstanceCount || s_Data.CircleInstanceCount || s_Data.LineVertexCount)
+			NextBatch();
+
+		s_Data.DepthBand = band;
+		float bandSize = 1.0f / Renderer2DData::DepthBandCount;
+		float farDepth = 1.0f - band * bandSize;
+		RenderCommand::SetDepthRange(std::max(farDepth - bandSize, 0.0f), farDepth);
+	}
+
+	// Sort key layout, most significant first:
+	//   8 bits  sorting layer
+	//   1 bit   translucent, so opaque draws of a layer come first
+	//   opaque:      7 bits primitive, 24 bits texture renderer ID, 24 bits depth front to back
+	//   translucent: 24 bits depth back to front, remaining bits zero so equal depths keep submission order
+	static uint64_t MakeSortKey(SortedDraw::Primitive primitive, bool translucent, uint32_t sortingLayer, uint32_t textureID, const glm::vec3& origin)
+	{
+		constexpr uint32_t DepthMask = 0xFFFFFF;
+
+		glm::vec4 clip = s_Data.CameraBuffer.ViewProjection * glm::vec4(origin, 1.0f);
+		float ndcDepth = clip.w > 0.0f ? clip.z / clip.w : -1.0f;
+		uint32_t depth = (uint32_t)(glm::clamp(ndcDepth * 0.5f + 0.5f, 0.0f, 1.0f) * (float)DepthMask);
+
+		uint64_t key = (uint64_t)(sortingLayer & 0xFF) << 56;
+		if (translucent)
+		{
+			key |= 1ull << 55;
+			key |= (uint64_t)(DepthMask - depth) << 31;
+		}
+		else
+		{
+			key |= (uint64_t)primitive << 48;
+			key |= (uint64_t)(textureID & DepthMask) << 24;
+			key |= depth;
+		}
+		return key;
+	}
+
+	static Math::QuadAxes GetQuadAxes(const glm::mat4& transform)
+	{
+		return { transform[0], transform[1], transform[3] };
+	}
+
+	// Safe to call from any JobSystem thread as long as each thread records into its own list
+	static void RecordSortedDraw(SortedDrawList& list, SortedDraw::Primitive primitive, const Math::QuadAxes& axes, const glm::vec4& color, const Ref<Texture2D>& texture, float tilingFactor, float fade, int entityID, int sortingLayer)
+	{
+		uint32_t textureIndex = 0;
+		if (texture)
+		{
+			auto it = list.TextureLookup.find(texture->GetRendererID());
+			if (it != list.TextureLookup.end())
+				textureIndex = it->second;
+			else
+			{
+				textureIndex = (uint32_t)list.Textures.size();
+				list.Textures.push_back(texture);
+				list.TextureLookup[texture->GetRendererID()] = textureIndex;
+			}
+		}
+
+		// Circles blend their edges and particles fade, so they always need ordering against what is behind them.
+		// Textures only count when some texel is actually see-through, not merely because they have an alpha channel
+		bool translucent = primitive != SortedDraw::Primitive::Quad || color.a < 1.0f || (texture && texture->IsTranslucent());
+
+		SortedDraw& draw = list.Draws.emplace_back();
+		draw.Right = axes.Right;
+		draw.Up = axes.Up;
+		draw.Origin = axes.Origin;
+		draw.Color = color;
+		draw.TextureIndex = textureIndex;
+		draw.TilingFactor = tilingFactor;
+		draw.Fade = fade;
+		draw.EntityID = entityID;
+		draw.Type = primitive;
+
+		SortEntry& entry = list.Entries.emplace_back();
+		entry.Key = MakeSortKey(primitive, translucent, (uint32_t)glm::clamp(sortingLayer, 0, 255), texture ? texture->GetRendererID() : 0, draw.Origin);
+		entry.Index = (uint32_t)list.Draws.size() - 1;
+		entry.List = list.ListIndex;
+	}
+
+	// LSD radix sort over 8-bit digits. Stable, and skips digits shared by every key
+	static void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		const size_t count = entries.size();
+		if (count < 2)
+			return;
+
+		scratch.resize(count);
+
+		uint32_t histograms[8][256] = {};
+		for (const SortEntry& entry : entries)
+		{
+			for (uint32_t digit = 0; digit < 8; digit++)
+				histograms[digit][(entry.Key >> (digit * 8)) & 0xFF]++;
+		}
+
+		SortEntry* source = entries.data();
+		SortEntry* destination = scratch.data();
+		for (uint32_t digit = 0; digit < 8; digit++)
+		{
+			uint32_t shift = digit * 8;
+			uint32_t* histogram = histograms[digit];
+			if (histogram[(source[0].Key >> shift) & 0xFF] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < 256; bucket++)
+			{
+				uint32_t bucketCount = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				destination[histogram[(source[i].Key >> shift) & 0xFF]++] = source[i];
+
+			std::swap(source, destination);
+		}
+
+		if (source != entries.data())
+			entries.swap(scratch);
+	}
+
+	static void ReclaimExpiredTextureLayers(uint32_t pageIndex)
+	{
+		auto& page = s_Data.TextureArrayPages[pageIndex];
+		for (auto it = s_Data.TextureArrayEntries.begin(); it != s_Data.TextureArrayEntries.end();)
+		{
+			if (it->second.Page == pageIndex && it->second.Texture.expired())
+			{
+				page.FreeLayers.push_back(it->second.Layer);
+				it = s_Data.TextureArrayEntries.erase(it);
+			}
+			else
+				it++;
+		}
+	}
+
+	// Returns the array layer holding texture, copying it into its page on first use and again after SetData.
+	// Returns nullptr when the page for its size is full.
+	static Renderer2DData::TextureArrayEntry* GetTextureArrayEntry(const Ref<Texture2D>& texture)
+	{
+		uint32_t rendererID = texture->GetRendererID();
+		auto entryIt = s_Data.TextureArrayEntries.find(rendererID);
+		if (entryIt != s_Data.TextureArrayEntries.end())
+		{
+			auto& entry = entryIt->second;
+			if (entry.Texture.lock() == texture)
+			{
+				if (entry.Version != texture->GetVersion())
+				{
+					s_Data.TextureArrayPages[entry.Page].Array->CopyToLayer(texture, entry.Layer);
+					entry.Version = texture->GetVersion();
+				}
+				return &entry;
+			}
+
+			// The renderer ID now belongs to a different texture
+			s_Data.TextureArrayPages[entry.Page].FreeLayers.push_back(entry.Layer);
+			s_Data.TextureArrayEntries.erase(entryIt);
+		}
+
+		uint32_t width = texture->GetWidth(), height = texture->GetHeight();
+		uint64_t sizeKey = ((uint64_t)width << 32) | height;
+
+		uint32_t pageIndex;
+		auto pageIt = s_Data.TextureArrayPageLookup.find(sizeKey);
+		if (pageIt == s_Data.TextureArrayPageLookup.end())
+		{
+			pageIndex = (uint32_t)s_Data.TextureArrayPages.size();
+			s_Data.TextureArrayPageLookup[sizeKey] = pageIndex;
+
+			auto& newPage = s_Data.TextureArrayPages.emplace_back();
+			newPage.Array = Texture2DArray::Create(width, height, Renderer2DData::InitialTextureArrayLayers);
+		}
+		else
+			pageIndex = pageIt->second;
+
+		auto& page = s_Data.TextureArrayPages[pageIndex];
+		uint32_t capacity = page.Array->GetLayerCount();
+		if (page.FreeLayers.empty() && page.LayerCount == capacity)
+		{
+			ReclaimExpiredTextureLayers(pageIndex);
+
+			if (page.FreeLayers.empty())
+			{
+				if (capacity >= Renderer2DData::MaxTextureArrayLayers)
+					return nullptr;
+
+				// Grow the page, the new array replaces the old one in any batch slot it is bound to
+				Ref<Texture2DArray> grown = Texture2DArray::Create(width, height, std::min<uint32_t>(capacity * 2, (uint32_t)Renderer2DData::MaxTextureArrayLayers));
+				grown->CopyLayers(page.Array, page.LayerCount);
+				page.Array = grown;
+			}
+		}
+
+		uint32_t layer;
+		if (!page.FreeLayers.empty())
+		{
+			layer = page.FreeLayers.back();
+			page.FreeLayers.pop_back();
+		}
+		else
+			layer = page.LayerCount++;
+
+		page.Array->CopyToLayer(texture, layer);
+
+		auto& entry = s_Data.TextureArrayEntries[rendererID];
+		entry.Texture = texture;
+		entry.Page = pageIndex;
+		entry.Layer = layer;
+		entry.Version = texture->GetVersion();
+		return &entry;
+	}
+
+	// Resolves the texture index and layer a quad in the current batch uses for texture.
+	// Returns false when the batch has no binding left for it
+	static bool TryGetTextureBinding(const Ref<Texture2D>& texture, float& textureIndex, float& textureLayer)
+	{
+		textureLayer = 0.0f;
+
+		if (s_Data.BindingMode == Renderer2D::TextureBindingMode::TextureArrays
+			&& texture->GetWidth() <= Renderer2DData::MaxTextureArraySize
+			&& texture->GetHeight() <= Renderer2DData::MaxTextureArraySize)
+		{
+			if (Renderer2DData::TextureArrayEntry* entry = GetTextureArrayEntry(texture))
+			{
+				auto& page = s_Data.TextureArrayPages[entry->Page];
+				if (page.BatchSlot < 0)
+				{
+					if (s_Data.TextureArraySlotIndex >= Renderer2DData::MaxTextureArraySlots)
+						return false;
+
+					page.BatchSlot = (int32_t)s_Data.TextureArraySlotIndex;
+					s_Data.TextureArraySlots[s_Data.TextureArraySlotIndex] = entry->Page;
+					s_Data.TextureArraySlotIndex++;
+				}
+
+				textureIndex = (float)(Renderer2DData::MaxTextureSlots + page.BatchSlot);
+				textureLayer = (float)entry->Layer;
+				return true;
+			}
+		}
+
+		auto slotIt = s_Data.TextureSlotLookup.find(texture->GetRendererID());
+		if (slotIt != s_Data.TextureSlotLookup.end())
+		{
+			textureIndex = (float)slotIt->second;
+			return true;
+		}
+
+		if (s_Data.TextureSlotIndex >= Renderer2DData::MaxTextureSlots)
+			return false;
+
+		textureIndex = (float)s_Data.TextureSlotIndex;
+		s_Data.TextureSlots[s_Data.TextureSlotIndex] = texture;
+		s_Data.TextureSlotLookup[texture->GetRendererID()] = s_Data.TextureSlotIndex;
+		s_Data.TextureSlotIndex++;
+		return true;
+	}
+
+	void Renderer2D::GetTextureBinding(const Ref<Texture2D>& texture, float& textureIndex, float& textureLayer)
+	{
+		if (!TryGetTextureBinding(texture, textureIndex, textureLayer))
+		{
+			NextBatch();
+			TryGetTextureBinding(texture, textureIndex, textureLayer);
+		}
+	}
+
+	void Renderer2D::EmitSortedDraws()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		s_Data.SortEntries.clear();
+		for (const SortedDrawList* list : s_Data.SortedLists)
+			s_Data.SortEntries.insert(s_Data.SortEntries.end(), list->Entries.begin(), list->Entries.end());
+
+		RadixSort(s_Data.SortEntries, s_Data.SortScratch);
+
+		const std::vector<SortEntry>& entries = s_Data.SortEntries;
+		const size_t entryCount = entries.size();
+		size_t i = 0;
+		while (i < entryCount)
+		{
+			const SortedDraw& first = s_Data.SortedLists[entries[i].List]->Draws[entries[i].Index];
+
+			uint32_t layerBand = Renderer2DData::FirstLayerDepthBand + (uint32_t)(entries[i].Key >> 56);
+			if (layerBand != s_Data.DepthBand)
+				SetDepthBand(layerBand);
+
+			if (first.Type == SortedDraw::Primitive::Circle)
+			{
+				EmitCircle(first.Right, first.Up, first.Origin, first.Color, first.TilingFactor, first.Fade, first.EntityID);
+				i++;
+				continue;
+			}
+
+			// A batch draws its quads before its circles, so a quad sorted after a circle needs a new batch
+			if (s_Data.CircleInstanceCount)
+				NextBatch();
+
+			if (first.Type == SortedDraw::Primitive::Particles)
+			{
+				const SortedDrawList& list = *s_Data.SortedLists[entries[i].List];
+				EmitParticles(*list.Pools[first.PoolIndex], list.Textures[first.TextureIndex], first.Origin.z, first.EntityID);
+				i++;
+				continue;
+			}
+
+			// Resolve textures serially for the longest run of quads that fits in the current batch
+			size_t runEnd = i;
+			size_t capacity = Renderer2DData::MaxQuads - s_Data.QuadInstanceCount;
+			while (runEnd < entryCount && runEnd - i < capacity)
+			{
+				const SortedDrawList& list = *s_Data.SortedLists[entries[runEnd].List];
+				const SortedDraw& draw = list.Draws[entries[runEnd].Index];
+				if (draw.Type != SortedDraw::Primitive::Quad || (entries[runEnd].Key >> 56) != (entries[i].Key >> 56))
+					break;
+
+				glm::vec2& resolved = s_Data.ResolvedTextures[runEnd - i];
+				resolved = { 0.0f, 0.0f }; // White texture
+				if (draw.TextureIndex && !TryGetTextureBinding(list.Textures[draw.TextureIndex], resolved.x, resolved.y))
+					break;
+
+				runEnd++;
+			}
+
+			if (runEnd == i)
+			{
+				NextBatch();
+				continue;
+			}
+
+			// Then write the run's instances in parallel, each thread into its own slice of the mapped buffer
+			uint32_t runCount = (uint32_t)(runEnd - i);
+			const SortEntry* runEntries = entries.data() + i;
+			QuadInstance* instances = s_Data.QuadInstanceBufferPtr;
+			JobSystem::ParallelFor(runCount, 4096, [&](uint32_t begin, uint32_t end, uint32_t)
+			{
+				for (uint32_t j = begin; j < end; j++)
+				{
+					const SortEntry& entry = runEntries[j];
+					const SortedDraw& draw = s_Data.SortedLists[entry.List]->Draws[entry.Index];
+
+					const glm::vec2& resolved = s_Data.ResolvedTextures[j];
+					WriteQuadInstance(instances[j], draw.Right, draw.Up, draw.Origin, draw.Color, resolved.x, resolved.y, draw.TilingFactor, draw.EntityID);
+				}
+			});
+
+			s_Data.QuadInstanceBufferPtr += runCount;
+			s_Data.QuadInstanceCount += runCount;
+			s_Data.Stats.QuadCount += runCount;
+			i = runEnd;
+		}
+
+		for (SortedDrawList* list : s_Data.SortedLists)
+			list->Clear();
+
+		SetDepthBand(Renderer2DData::UnsortedDepthBand);
+	}
+
 	void Renderer2D::DrawQuadFilled(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
 	{
 		DrawQuadFilled({ position.x, position.y, 0.0f }, size, color);
@@ -324,28 +980,10 @@ namespace phx
 	{
 		PHX_PROFILE_FUNCTION();
 
-		constexpr size_t quadVertexCount = 4;
-		const float textureIndex = 0.0f; // White Texture
-		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
-		const float tilingFactor = 1.0f;
-
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-			NextBatch();
-
-		for (size_t i = 0; i < quadVertexCount; i++)
-		{
-			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr->Color = color;
-			s_Data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_Data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_Data.QuadVertexBufferPtr->EntityID = entityID;
-			s_Data.QuadVertexBufferPtr++;
-		}
-
-		s_Data.QuadIndexCount += 6;
-
-		s_Data.Stats.QuadCount++;
+		if (s_Data.Submission == SubmissionMode::Sorted)
+			RecordSortedDraw(GetMainDrawList(), SortedDraw::Primitive::Quad, GetQuadAxes(transform), color, nullptr, 1.0f, 0.0f, entityID, 0);
+		else
+			EmitQuad(transform[0], transform[1], transform[3], color, nullptr, 1.0f, entityID);
 	}
 
 	void Renderer2D::DrawRotatedQuadFilled(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color)
@@ -357,44 +995,25 @@ namespace phx
 	{
 		PHX_PROFILE_FUNCTION();
 
-		constexpr size_t quadVertexCount = 4;
-		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		if (s_Data.Submission == SubmissionMode::Sorted)
+			RecordSortedDraw(GetMainDrawList(), SortedDraw::Primitive::Quad, GetQuadAxes(transform), tintColor, texture, tilingFactor, 0.0f, entityID, 0);
+		else
+			EmitQuad(transform[0], transform[1], transform[3], tintColor, texture, tilingFactor, entityID);
+	}
 
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
+	void Renderer2D::EmitQuad(const glm::vec3& right, const glm::vec3& up, const glm::vec3& origin, const glm::vec4& color, const Ref<Texture2D>& texture, float tilingFactor, int entityID)
+	{
+		if (s_Data.QuadInstanceCount >= Renderer2DData::MaxQuads)
 			NextBatch();
 
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++)
-		{
-			if (*s_Data.TextureSlots[i].get() == *texture.get())
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
-
-		if (textureIndex == 0.0f)
-		{
-			if (s_Data.TextureSlotIndex >= Renderer2DData::MaxTextureSlots)
-				NextBatch();
-
-			textureIndex = (float)s_Data.TextureSlotIndex;
-			s_Data.TextureSlots[s_Data.TextureSlotIndex] = texture;
-			s_Data.TextureSlotIndex++;
-		}
+		float textureIndex = 0.0f, textureLayer = 0.0f; // White Texture
+		if (texture)
+			GetTextureBinding(texture, textureIndex, textureLayer);
 
-		for (size_t i = 0; i < quadVertexCount; i++)
-		{
-			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr->Color = tintColor;
-			s_Data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_Data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_Data.QuadVertexBufferPtr->EntityID = entityID;
-			s_Data.QuadVertexBufferPtr++;
-		}
+		WriteQuadInstance(*s_Data.QuadInstanceBufferPtr, right, up, origin, color, textureIndex, textureLayer, tilingFactor, entityID);
+		s_Data.QuadInstanceBufferPtr++;
 
-		s_Data.QuadIndexCount += 6;
+		s_Data.QuadInstanceCount++;
 
 		s_Data.Stats.QuadCount++;
 	}
@@ -426,40 +1045,49 @@ namespace phx
 		DrawQuadFilled(transform, texture, tilingFactor, tintColor);
 	}
 
-	void Renderer2D::DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness /*= 1.0f*/, float fade /*= 0.005f*/, int entityID /*= -1*/)
+	void Renderer2D::DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness /*= 1.0f*/, float fade /*= 0.005f*/, int entityID /*= -1*/, int sortingLayer /*= 0*/)
 	{
 		PHX_PROFILE_FUNCTION();
 
-		// TODO: implement for circles
-		// if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-		// 	NextBatch();
+		if (s_Data.Submission == SubmissionMode::Sorted)
+			RecordSortedDraw(GetMainDrawList(), SortedDraw::Primitive::Circle, GetQuadAxes(transform), color, nullptr, thickness, fade, entityID, sortingLayer);
+		else
+			EmitCircle(transform[0], transform[1], transform[3], color, thickness, fade, entityID);
+	}
 
-		for (size_t i = 0; i < 4; i++)
-		{
-			s_Data.CircleVertexBufferPtr->WorldPosition = transform * s_Data.QuadVertexPositions[i];
-			s_Data.CircleVertexBufferPtr->LocalPosition = s_Data.QuadVertexPositions[i] * 2.0f;
-			s_Data.CircleVertexBufferPtr->Color = color;
-			s_Data.CircleVertexBufferPtr->Thickness = thickness;
-			s_Data.CircleVertexBufferPtr->Fade = fade;
-			s_Data.CircleVertexBufferPtr->EntityID = entityID;
-			s_Data.CircleVertexBufferPtr++;
-		}
+	void Renderer2D::EmitCircle(const glm::vec3& right, const glm::vec3& up, const glm::vec3& origin, const glm::vec4& color, float thickness, float fade, int entityID)
+	{
+		if (s_Data.CircleInstanceCount >= Renderer2DData::MaxQuads)
+			NextBatch();
+
+		WriteCircleInstance(*s_Data.CircleInstanceBufferPtr, right, up, origin, color, thickness, fade, entityID);
+		s_Data.CircleInstanceBufferPtr++;
 
-		s_Data.CircleIndexCount += 6;
+		s_Data.CircleInstanceCount++;
 
 		s_Data.Stats.QuadCount++;
 	}
 
 	void Renderer2D::DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color, int entityID)
 	{
+		// Writing past the region would land in one the GPU may still be reading
+		if (s_Data.LineVertexCount + 2 > Renderer2DData::MaxVertices)
+			NextBatch();
+
+		uint32_t packedColor = glm::packUnorm4x8(color);
+
 		s_Data.LineVertexBufferPtr->Position = p0;
-		s_Data.LineVertexBufferPtr->Color = color;
+		s_Data.LineVertexBufferPtr->Color = packedColor;
+#ifdef PHX_RENDERER_ENTITY_ID
 		s_Data.LineVertexBufferPtr->EntityID = entityID;
+#endif
 		s_Data.LineVertexBufferPtr++;
 
 		s_Data.LineVertexBufferPtr->Position = p1;
-		s_Data.LineVertexBufferPtr->Color = color;
+		s_Data.LineVertexBufferPtr->Color = packedColor;
+#ifdef PHX_RENDERER_ENTITY_ID
 		s_Data.LineVertexBufferPtr->EntityID = entityID;
+#endif
 		s_Data.LineVertexBufferPtr++;
 
 		s_Data.LineVertexCount += 2;
@@ -494,6 +1122,11 @@ namespace phx
 		DrawLine(lineVertices[3], lineVertices[0], color);
 	}
 
+	const Math::AABB2D& Renderer2D::GetViewBounds()
+	{
+		return s_Data.ViewBounds;
+	}
+
 	float Renderer2D::GetLineWidth()
 	{
 		return s_Data.LineWidth;
@@ -504,8 +1137,38 @@ namespace phx
 		s_Data.LineWidth = width;
 	}
 
+	Renderer2D::SubmissionMode Renderer2D::GetSubmissionMode()
+	{
+		return s_Data.Submission;
+	}
+
+	void Renderer2D::SetSubmissionMode(SubmissionMode mode)
+	{
+		// Draws recorded so far keep their place ahead of anything drawn in the new mode
+		if (HasSortedDraws())
+			EmitSortedDraws();
+
+		s_Data.Submission = mode;
+	}
+
+	Renderer2D::TextureBindingMode Renderer2D::GetTextureBindingMode()
+	{
+		return s_Data.BindingMode;
+	}
+
+	void Renderer2D::SetTextureBindingMode(TextureBindingMode mode)
+	{
+		s_Data.BindingMode = mode;
+	}
+
 	void Renderer2D::DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID)
 	{
+		if (s_Data.Submission == SubmissionMode::Sorted)
+		{
+			RecordSortedDraw(GetMainDrawList(), SortedDraw::Primitive::Quad, GetQuadAxes(transform), src.Color, src.Texture, src.TilingFactor, 0.0f, entityID, src.SortingLayer);
+			return;
+		}
+
 		if (src.Texture)
 		{
 			DrawQuadFilled(transform, src.Texture, src.TilingFactor, src.Color, entityID);
@@ -517,6 +1180,352 @@ namespace phx
 
 	}
 
+	void Renderer2D::DrawSprite(const Math::QuadAxes& axes, SpriteRendererComponent& src, int entityID)
+	{
+		if (s_Data.Submission == SubmissionMode::Sorted)
+		{
+			RecordSortedDraw(GetMainDrawList(), SortedDraw::Primitive::Quad, axes, src.Color, src.Texture, src.TilingFactor, 0.0f, entityID, src.SortingLayer);
+			return;
+		}
+
+		EmitQuad(axes.Right, axes.Up, axes.Origin, src.Color, src.Texture, src.TilingFactor, entityID);
+	}
+
+	Renderer2D::DrawList::DrawList()
+		: m_List(CreateScope<SortedDrawList>())
+	{
+		m_List->Textures.emplace_back(); // Untextured draws
+	}
+
+	Renderer2D::DrawList::~DrawList() = default;
+
+	void Renderer2D::DrawList::DrawQuad(const glm::mat4& transform, const glm::vec4& color, const Ref<Texture2D>& texture, float tilingFactor, int entityID, int sortingLayer)
+	{
+		RecordSortedDraw(*m_List, SortedDraw::Primitive::Quad, GetQuadAxes(transform), color, texture, tilingFactor, 0.0f, entityID, sortingLayer);
+	}
+
+	void Renderer2D::DrawList::DrawSprite(const glm::mat4& transform, const SpriteRendererComponent& src, int entityID)
+	{
+		RecordSortedDraw(*m_List, SortedDraw::Primitive::Quad, GetQuadAxes(transform), src.Color, src.Texture, src.TilingFactor, 0.0f, entityID, src.SortingLayer);
+	}
+
+	void Renderer2D::DrawList::DrawSprite(const Math::QuadAxes& axes, const SpriteRendererComponent& src, int entityID)
+	{
+		RecordSortedDraw(*m_List, SortedDraw::Primitive::Quad, axes, src.Color, src.Texture, src.TilingFactor, 0.0f, entityID, src.SortingLayer);
+	}
+
+	void Renderer2D::DrawList::DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness, float fade, int entityID, int sortingLayer)
+	{
+		RecordSortedDraw(*m_List, SortedDraw::Primitive::Circle, GetQuadAxes(transform), color, nullptr, thickness, fade, entityID, sortingLayer);
+	}
+
+	Renderer2D::DrawList& Renderer2D::GetDrawList(uint32_t index)
+	{
+		PHX_CORE_ASSERT(index < s_Data.DrawLists.size(), "Draw list index out of range!");
+		PHX_CORE_ASSERT(s_Data.Submission == SubmissionMode::Sorted, "Draw lists require sorted submission!");
+
+		return *s_Data.DrawLists[index];
+	}
+
+	uint32_t Renderer2D::GetDrawListCount()
+	{
+		return (uint32_t)s_Data.DrawLists.size();
+	}
+
+	// Returns the batch texture slot of the texture and takes a reference to it, or -1 if every slot is taken
+	static int32_t AcquireStaticTexture(StaticBatchData& data, const Ref<Texture2D>& texture)
+	{
+		if (!texture)
+			return 0;
+
+		auto it = data.TextureLookup.find(texture->GetRendererID());
+		if (it != data.TextureLookup.end())
+		{
+			data.TextureRefs[it->second]++;
+			return (int32_t)it->second;
+		}
+
+		for (uint32_t i = 1; i < Renderer2DData::MaxTextureSlots; i++)
+		{
+			if (data.Textures[i])
+				continue;
+
+			data.Textures[i] = texture;
+			data.TextureRefs[i] = 1;
+			data.TextureLookup[texture->GetRendererID()] = i;
+			return (int32_t)i;
+		}
+
+		return -1;
+	}
+
+	static void ReleaseStaticTexture(StaticBatchData& data, uint32_t textureSlot)
+	{
+		if (textureSlot == 0 || --data.TextureRefs[textureSlot] > 0)
+			return;
+
+		data.TextureLookup.erase(data.Textures[textureSlot]->GetRendererID());
+		data.Textures[textureSlot] = nullptr;
+	}
+
+	static void WriteStaticInstance(QuadInstance& instance, const Math::QuadAxes& axes, const SpriteRendererComponent& src, uint32_t textureSlot, int entityID)
+	{
+		WriteQuadInstance(instance, axes.Right, axes.Up, axes.Origin, src.Color, (float)textureSlot, 0.0f, src.TilingFactor, entityID);
+	}
+
+	Renderer2D::StaticBatch::StaticBatch()
+		: m_Data(CreateScope<StaticBatchData>())
+	{
+	}
+
+	Renderer2D::StaticBatch::~StaticBatch() = default;
+
+	int32_t Renderer2D::StaticBatch::Add(const Math::QuadAxes& axes, const SpriteRendererComponent& src, int entityID)
+	{
+		int32_t textureSlot = AcquireStaticTexture(*m_Data, src.Texture);
+		if (textureSlot < 0)
+			return -1;
+
+		uint32_t slot = (uint32_t)m_Data->Instances.size();
+		WriteStaticInstance(m_Data->Instances.emplace_back(), axes, src, (uint32_t)textureSlot, entityID);
+		m_Data->MarkDirty(slot);
+		return (int32_t)slot;
+	}
+
+	bool Renderer2D::StaticBatch::Update(uint32_t slot, const Math::QuadAxes& axes, const SpriteRendererComponent& src, int entityID)
+	{
+		PHX_CORE_ASSERT(slot < m_Data->Instances.size(), "Static batch slot out of range!");
+
+		// Acquire before releasing so an unchanged texture keeps its slot
+		int32_t textureSlot = AcquireStaticTexture(*m_Data, src.Texture);
+		if (textureSlot < 0)
+			return false;
+
+		QuadInstance& instance = m_Data->Instances[slot];
+		ReleaseStaticTexture(*m_Data, (uint32_t)instance.TexIndex);
+		WriteStaticInstance(instance, axes, src, (uint32_t)textureSlot, entityID);
+		m_Data->MarkDirty(slot);
+		return true;
+	}
+
+	void Renderer2D::StaticBatch::Remove(uint32_t slot)
+	{
+		PHX_CORE_ASSERT(slot < m_Data->Instances.size(), "Static batch slot out of range!");
+
+		ReleaseStaticTexture(*m_Data, (uint32_t)m_Data->Instances[slot].TexIndex);
+
+		if (slot != m_Data->Instances.size() - 1)
+		{
+			m_Data->Instances[slot] = m_Data->Instances.back();
+			m_Data->MarkDirty(slot);
+		}
+		m_Data->Instances.pop_back();
+	}
+
+	void Renderer2D::StaticBatch::Clear()
+	{
+		m_Data->Instances.clear();
+		m_Data->DirtyBegin = m_Data->DirtyEnd = 0;
+
+		m_Data->Textures.fill(nullptr);
+		m_Data->TextureRefs.fill(0);
+		m_Data->TextureLookup.clear();
+	}
+
+	uint32_t Renderer2D::StaticBatch::GetCount() const
+	{
+		return (uint32_t)m_Data->Instances.size();
+	}
+
+	void Renderer2D::DrawStaticBatch(StaticBatch& batch)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		StaticBatchData& data = *batch.m_Data;
+		uint32_t count = (uint32_t)data.Instances.size();
+		if (count == 0)
+			return;
+
+		// Static sprites get their own band so dynamic ones at the same z still draw on top of them
+		uint32_t previousBand = s_Data.DepthBand;
+		SetDepthBand(Renderer2DData::StaticDepthBand);
+
+		if (count > data.Capacity)
+		{
+			data.Capacity = std::max(count, data.Capacity * 2);
+
+			data.InstanceBuffer = VertexBuffer::Create(data.Capacity * sizeof(QuadInstance));
+			data.InstanceBuffer->SetLayout(s_Data.QuadInstanceBuffer->GetLayout());
+
+			data.QuadVertexArray = VertexArray::Create();
+			data.QuadVertexArray->AddVertexBuffer(s_Data.UnitQuadVertexBuffer);
+			data.QuadVertexArray->AddInstanceBuffer(data.InstanceBuffer);
+			data.QuadVertexArray->SetIndexBuffer(s_Data.UnitQuadIndexBuffer);
+
+			data.DirtyBegin = 0;
+			data.DirtyEnd = count;
+		}
+
+		// Slots past the end were removed since the last upload
+		data.DirtyEnd = std::min(data.DirtyEnd, count);
+		if (data.DirtyBegin < data.DirtyEnd)
+		{
+			uint32_t dirtyCount = data.DirtyEnd - data.DirtyBegin;
+			data.InstanceBuffer->SetData(&data.Instances[data.DirtyBegin], dirtyCount * sizeof(QuadInstance), data.DirtyBegin * sizeof(QuadInstance));
+		}
+		data.DirtyBegin = data.DirtyEnd = 0;
+
+		s_Data.WhiteTexture->Bind(0);
+		for (uint32_t i = 1; i < Renderer2DData::MaxTextureSlots; i++)
+		{
+			if (data.Textures[i])
+				data.Textures[i]->Bind(i);
+		}
+
+		s_Data.QuadShader->Bind();
+		RenderCommand::DrawIndexedInstanced(data.QuadVertexArray, 6, count);
+		s_Data.Stats.DrawCalls++;
+		s_Data.Stats.QuadCount += count;
+
+		SetDepthBand(previousBand);
+	}
+
+	void Renderer2D::DrawParticles(const ParticlePool& pool, const Ref<Texture2D>& texture, const glm::vec3& origin, int entityID, int sortingLayer)
+	{
+		if (pool.GetCount() == 0)
+			return;
+
+		if (s_Data.Submission == SubmissionMode::Sorted)
+		{
+			// The pool sorts as a single translucent draw at the origin, so it is emitted whole in its layer
+			SortedDrawList& list = GetMainDrawList();
+			RecordSortedDraw(list, SortedDraw::Primitive::Particles, { glm::vec3(0.0f), glm::vec3(0.0f), origin }, glm::vec4(1.0f), texture, 1.0f, 0.0f, entityID, sortingLayer);
+			list.Draws.back().PoolIndex = (uint32_t)list.Pools.size();
+			list.Pools.push_back(&pool);
+		}
+		else
+		{
+			EmitParticles(pool, texture, origin.z, entityID);
+		}
+	}
+
+	void Renderer2D::EmitParticles(const ParticlePool& pool, const Ref<Texture2D>& texture, float z, int entityID)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		static const uint32_t TexRectMin = glm::packUnorm2x16(glm::vec2(0.0f));
+		static const uint32_t TexRectMax = glm::packUnorm2x16(glm::vec2(1.0f));
+		static const uint32_t TilingFactor = glm::packHalf2x16({ 1.0f, 0.0f });
+		static constexpr uint32_t GrainSize = 4096;
+
+		const float* positionX = pool.GetPositionX();
+		const float* positionY = pool.GetPositionY();
+		const float* rightX = pool.GetRightX();
+		const float* rightY = pool.GetRightY();
+		const uint32_t* colors = pool.GetColors();
+
+		// Fill whatever room the current batch has left, then continue in fresh batches
+		uint32_t count = pool.GetCount();
+		uint32_t emitted = 0;
+		while (emitted < count)
+		{
+			if (s_Data.QuadInstanceCount >= Renderer2DData::MaxQuads)
+				NextBatch();
+
+			float textureIndex = 0.0f, textureLayer = 0.0f; // White Texture
+			if (texture)
+				GetTextureBinding(texture, textureIndex, textureLayer);
+
+			uint32_t batchCount = std::min(count - emitted, Renderer2DData::MaxQuads - s_Data.QuadInstanceCount);
+			QuadInstance* instances = s_Data.QuadInstanceBufferPtr;
+			const uint32_t first = emitted;
+			JobSystem::ParallelFor(batchCount, GrainSize, [&](uint32_t begin, uint32_t end, uint32_t)
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					uint32_t particle = first + i;
+					QuadInstance& instance = instances[i];
+					instance.Right = { rightX[particle], rightY[particle], 0.0f };
+					instance.Up = { -rightY[particle], rightX[particle], 0.0f };
+					instance.Origin = { positionX[particle], positionY[particle], z };
+					instance.Color = colors[particle];
+					instance.TexRectMin = TexRectMin;
+					instance.TexRectMax = TexRectMax;
+					instance.TexIndex = (uint16_t)textureIndex;
+					instance.TexLayer = (uint16_t)textureLayer;
+					instance.TilingFactor = TilingFactor;
+#ifdef PHX_RENDERER_ENTITY_ID
+					instance.EntityID = entityID;
+#endif
+				}
+			});
+
+			s_Data.QuadInstanceBufferPtr += batchCount;
+			s_Data.QuadInstanceCount += batchCount;
+			s_Data.Stats.QuadCount += batchCount;
+			emitted += batchCount;
+		}
+	}
+
+	void Renderer2D::DrawTilemap(const glm::mat4& transform, TilemapComponent& tilemap, int entityID)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		if (!tilemap.Atlas || tilemap.GetChunks().empty())
+			return;
+
+		// Tilemaps are backgrounds, so they get the farthest band
+		uint32_t previousBand = s_Data.DepthBand;
+		SetDepthBand(Renderer2DData::TilemapDepthBand);
+
+		s_Data.TilemapShader->Bind();
+		tilemap.Atlas->Bind(1);
+
+		s_Data.TilemapBuffer.Color = tilemap.Color;
+		s_Data.TilemapBuffer.AtlasGrid = { std::max(tilemap.AtlasColumns, 1), std::max(tilemap.AtlasRows, 1) };
+		s_Data.TilemapBuffer.ChunkSize = (int)TilemapComponent::ChunkSize;
+		s_Data.TilemapBuffer.EntityID = entityID;
+
+		glm::vec2 chunkExtent = tilemap.TileSize * (float)TilemapComponent::ChunkSize;
+		glm::mat4 chunkScale = glm::scale(glm::mat4(1.0f), { chunkExtent.x, chunkExtent.y, 1.0f });
+
+		auto& chunks = tilemap.GetChunks();
+		uint32_t columns = tilemap.GetChunkColumns();
+		for (uint32_t i = 0; i < (uint32_t)chunks.size(); i++)
+		{
+			TilemapComponent::Chunk& chunk = chunks[i];
+			if (chunk.TileCount == 0)
+				continue;
+
+			glm::vec3 chunkCenter = { ((i % columns) + 0.5f) * chunkExtent.x, ((i / columns) + 0.5f) * chunkExtent.y, 0.0f };
+			glm::mat4 chunkTransform = transform * glm::translate(glm::mat4(1.0f), chunkCenter) * chunkScale;
+			if (!Math::ComputeQuadBounds(GetQuadAxes(chunkTransform)).Intersects(s_Data.ViewBounds))
+				continue;
+
+			// Chunks that changed while off screen are uploaded once they come into view
+			if (!chunk.IndexTexture)
+			{
+				chunk.IndexTexture = IndexTexture2D::Create(TilemapComponent::ChunkSize, TilemapComponent::ChunkSize);
+				chunk.Dirty = true;
+			}
+			if (chunk.Dirty)
+			{
+				chunk.IndexTexture->SetData(chunk.Tiles.data());
+				chunk.Dirty = false;
+			}
+
+			s_Data.TilemapBuffer.ChunkTransform = chunkTransform;
+			s_Data.TilemapUniformBuffer->SetData(&s_Data.TilemapBuffer, sizeof(Renderer2DData::TilemapData));
+			chunk.IndexTexture->Bind(0);
+
+			RenderCommand::DrawIndexed(s_Data.TilemapVertexArray, 6);
+			s_Data.Stats.DrawCalls++;
+			s_Data.Stats.QuadCount++;
+		}
+
+		SetDepthBand(previousBand);
+	}
+
 	void Renderer2D::ResetStats()
 	{
 		memset(&s_Data.Stats, 0, sizeof(Statistics));
@@ -5,9 +5,14 @@
 #include "Phoenix/Renderer/EditorCamera.h"
 #include "Phoenix/Renderer/Texture.h"
 
+#include "Phoenix/Math/QuadTransforms.h"
+
 #include "Phoenix/Scene/Components.h"
 
 namespace phx {
+	struct SortedDrawList;
+	struct StaticBatchData;
+
 	class Renderer2D
 	{
 	public:
@@ -36,15 +41,100 @@ namespace phx {
 
 
 		static void DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
-		static void DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f, int entityID = -1);
+		// Takes axes precomputed in bulk with Math::ComputeQuadAxes
+		static void DrawSprite(const Math::QuadAxes& axes, SpriteRendererComponent& src, int entityID);
+		static void DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f, int entityID = -1, int sortingLayer = 0);
 		static void DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color, int entityID = -1);
 
 		static void DrawRect(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, int entityID = -1);
 		static void DrawRect(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
 
+		// World-space XY bounds of what the camera passed to BeginScene can see, for culling before submission
+		static const Math::AABB2D& GetViewBounds();
+
 		static float GetLineWidth();
 		static void SetLineWidth(float width);
 
+		// TextureArrays packs same-sized textures into layers of shared array textures, so a batch is not
+		// broken every time it reaches the texture slot limit. Slots binds every texture to its own unit
+		enum class TextureBindingMode
+		{
+			Slots = 0,
+			TextureArrays
+		};
+		static TextureBindingMode GetTextureBindingMode();
+		static void SetTextureBindingMode(TextureBindingMode mode);
+
+		// Sorted records quads and circles and draws them at EndScene ordered by sorting layer, then opaque before
+		// translucent. Opaque draws are grouped by primitive and texture, translucent ones go back to front.
+		// Each layer is drawn into its own slice of the depth range, so a higher layer is on top whatever its z.
+		// Immediate draws everything in submission order, above every sorted layer
+		enum class SubmissionMode
+		{
+			Immediate = 0,
+			Sorted
+		};
+		static SubmissionMode GetSubmissionMode();
+		static void SetSubmissionMode(SubmissionMode mode);
+
+		// Records sorted quads and circles. Lists can be filled from different threads at once and are merged
+		// in list order before the stable sort at EndScene, so recording consecutive slices of a scene into
+		// consecutive lists keeps submission order for equal keys. There is one list per JobSystem thread
+		class DrawList
+		{
+		public:
+			DrawList();
+			~DrawList();
+
+			void DrawQuad(const glm::mat4& transform, const glm::vec4& color, const Ref<Texture2D>& texture = nullptr, float tilingFactor = 1.0f, int entityID = -1, int sortingLayer = 0);
+			void DrawSprite(const glm::mat4& transform, const SpriteRendererComponent& src, int entityID);
+			void DrawSprite(const Math::QuadAxes& axes, const SpriteRendererComponent& src, int entityID);
+			void DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f, int entityID = -1, int sortingLayer = 0);
+		private:
+			Scope<SortedDrawList> m_List;
+
+			friend class Renderer2D;
+		};
+		// List 0 also receives the Draw* calls above. Requires sorted submission
+		static DrawList& GetDrawList(uint32_t index);
+		static uint32_t GetDrawListCount();
+
+		// Sprites baked into a GPU buffer of their own. Changed slots are re-uploaded as one dirty range at the
+		// next draw, so an unchanged batch costs a single draw call. Sprites draw in slot order with their own
+		// texture slots, which limits a batch to MaxTextureSlots - 1 distinct textures
+		class StaticBatch
+		{
+		public:
+			StaticBatch();
+			~StaticBatch();
+
+			// Returns the slot of the new sprite, or -1 if its texture no longer fits in the batch
+			int32_t Add(const Math::QuadAxes& axes, const SpriteRendererComponent& src, int entityID);
+			// Returns false and leaves the slot untouched if the new texture does not fit
+			bool Update(uint32_t slot, const Math::QuadAxes& axes, const SpriteRendererComponent& src, int entityID);
+			// Moves the last sprite into the freed slot
+			void Remove(uint32_t slot);
+			void Clear();
+
+			uint32_t GetCount() const;
+		private:
+			Scope<StaticBatchData> m_Data;
+
+			friend class Renderer2D;
+		};
+		// Draws immediately, after flushing whatever was drawn before it. The batch sits in depth beneath every
+		// dynamic quad and circle of the scene, above tilemaps
+		static void DrawStaticBatch(StaticBatch& batch);
+
+		// Draws every live particle of the pool as a quad in the plane z = origin.z, written straight into the quad
+		// batches. In sorted submission the whole pool is ordered as one translucent draw at the origin among the others
+		// of its sorting layer, and is read at EndScene, so it must stay alive and unchanged until then
+		static void DrawParticles(const ParticlePool& pool, const Ref<Texture2D>& texture = nullptr, const glm::vec3& origin = glm::vec3(0.0f), int entityID = -1, int sortingLayer = 0);
+
+		// Draws each visible, non-empty chunk with one draw, uploading the tiles of chunks that changed since their
+		// last draw. Draws immediately, after flushing whatever was drawn before it, and beneath everything else
+		static void DrawTilemap(const glm::mat4& transform, TilemapComponent& tilemap, int entityID = -1);
+
 		struct Statistics
 		{
 			uint32_t DrawCalls = 0;
@@ -58,5 +148,13 @@ namespace phx {
 	private:
 		static void StartBatch();
 		static void NextBatch();
+		static void SetDepthBand(uint32_t band);
+
+		static void GetTextureBinding(const Ref<Texture2D>& texture, float& textureIndex, float& textureLayer);
+
+		static void EmitQuad(const glm::vec3& right, const glm::vec3& up, const glm::vec3& origin, const glm::vec4& color, const Ref<Texture2D>& texture, float tilingFactor, int entityID);
+		static void EmitCircle(const glm::vec3& right, const glm::vec3& up, const glm::vec3& origin, const glm::vec4& color, float thickness, float fade, int entityID);
+		static void EmitSortedDraws();
+		static void EmitParticles(const ParticlePool& pool, const Ref<Texture2D>& texture, float z, int entityID);
 	};
 }
\ No newline at end of file
@@ -5,41 +5,315 @@
 #include "Phoenix/Renderer/Shader.h"
 #include "Phoenix/Renderer/UniformBuffer.h"
 #include "Phoenix/Renderer/RenderCommand.h"
-
-#include <Platform/OpenGL/OpenGLShader.h>
+#include "Phoenix/Renderer/RenderCommandBuffer.h"
+#include "Phoenix/Renderer/GPUProfiler.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace phx
 {
+	struct MeshCommand
+	{
+		uint64_t SortKey; // Shader renderer ID, then vertex array identity, then LOD
+		Ref<VertexArray> MeshVertexArray;
+		const Mesh* MeshSource; // Kept alive by its component until EndScene
+		uint32_t Lod;
+		Shader* MeshShader;
+		glm::mat4 Transform;
+		int EntityID;
+	};
+
+	// Consecutive indirect commands of one batch drawn with one multi-draw
+	struct IndirectGroup
+	{
+		uint32_t FirstCommand;
+		uint32_t CommandCount;
+		uint32_t Batch;
+		Ref<VertexArray> GroupVertexArray;
+		Shader* GroupShader;
+	};
+
+	struct Renderer3DData
+	{
+		Ref<Shader> MeshShader;
+
+		struct CameraData
+		{
+			glm::mat4 ViewProjection;
+		};
+		CameraData CameraBuffer;
+		Ref<UniformBuffer> CameraUniformBuffer;
+		glm::mat4 View;
+		float ProjectionScale; // Projected size of one unit at unit distance
+		bool Perspective;
+		Math::Frustum Frustum;
+
+		// Layout matches the std140 Objects block of the mesh shader
+		struct ObjectData
+		{
+			glm::mat4 Transforms[Renderer3D::MaxObjectsPerBatch];
+			glm::ivec4 EntityIDs[Renderer3D::MaxObjectsPerBatch / 4];
+		};
+		ObjectData ObjectBuffer;
+		Ref<UniformBuffer> ObjectUniformBuffer;
+		Ref<VertexBuffer> ObjectIndexBuffer; // 0, 1, ... MaxObjectsPerBatch - 1
+
+		std::vector<MeshCommand> Commands;
+		std::vector<DrawIndexedIndirectCommand> IndirectCommands;
+		std::vector<IndirectGroup> IndirectGroups;
+		Ref<IndirectBuffer> IndirectCommandBuffer;
+
+		Ref<RenderCommandBuffer> CommandBuffer; // Flush records into it, EndScene replays it
+
+		Renderer3D::Statistics Stats;
+	};
+
+	static Renderer3DData s_Data;
+
 	void Renderer3D::Init()
 	{
-		m_MeshShader = Shader::Create("MeshShader", "assets/shaders/Renderer3D_Mesh.vert", "assets/shaders/Renderer3D_Mesh.frag");
+		PHX_PROFILE_FUNCTION();
+
+		s_Data.MeshShader = Shader::Create("MeshShader", "assets/shaders/Renderer3D_Mesh.vert", "assets/shaders/Renderer3D_Mesh.frag");
+
+		s_Data.CameraUniformBuffer = UniformBuffer::Create(sizeof(Renderer3DData::CameraData), 2);
+		s_Data.ObjectUniformBuffer = UniformBuffer::Create(sizeof(Renderer3DData::ObjectData), 3);
+
+		uint32_t objectIndices[MaxObjectsPerBatch];
+		for (uint32_t i = 0; i < MaxObjectsPerBatch; i++)
+			objectIndices[i] = i;
+
+		s_Data.ObjectIndexBuffer = VertexBuffer::Create(sizeof(objectIndices));
+		s_Data.ObjectIndexBuffer->SetLayout({
+			{ ShaderDataType::Int, "a_ObjectIndex" }
+			});
+		s_Data.ObjectIndexBuffer->SetData(objectIndices, sizeof(objectIndices));
+
+		s_Data.IndirectCommandBuffer = IndirectBuffer::Create(MaxObjectsPerBatch * sizeof(DrawIndexedIndirectCommand));
+		s_Data.CommandBuffer = CreateRef<RenderCommandBuffer>();
 	}
+
+	const Ref<VertexBuffer>& Renderer3D::GetObjectIndexBuffer()
+	{
+		return s_Data.ObjectIndexBuffer;
+	}
+
+	void Renderer3D::SetCamera(const glm::mat4& projection, const glm::mat4& view)
+	{
+		s_Data.CameraBuffer.ViewProjection = projection * view;
+		s_Data.Frustum = Math::Frustum::FromViewProjection(s_Data.CameraBuffer.ViewProjection);
+
+		s_Data.View = view;
+		s_Data.ProjectionScale = projection[1][1];
+		s_Data.Perspective = projection[2][3] != 0.0f;
+
+		s_Data.Commands.clear();
+	}
+
 	void Renderer3D::BeginScene(const OrthographicCamera& camera)
 	{
-		m_SceneData.ViewProjectionMatrix = camera.GetViewProjectionMatrix();
+		SetCamera(camera.GetProjectionMatrix(), camera.GetViewMatrix());
+		GPUProfiler::BeginScope("Renderer3D Scene");
 	}
+
 	void Renderer3D::BeginScene(const EditorCamera& camera)
 	{
-		m_SceneData.ViewProjectionMatrix = camera.GetViewProjection();
+		SetCamera(camera.GetProjection(), camera.GetViewMatrix());
+		GPUProfiler::BeginScope("Renderer3D Scene");
 	}
+
 	void Renderer3D::BeginScene(const Camera& camera, const glm::mat4& transform)
 	{
-		m_SceneData.ViewProjectionMatrix = camera.GetProjection() * glm::inverse(transform);;
+		SetCamera(camera.GetProjection(), glm::inverse(transform));
+		GPUProfiler::BeginScope("Renderer3D Scene");
 	}
+
 	void Renderer3D::EndScene()
 	{
+		PHX_PROFILE_FUNCTION();
+
+		// Replayed right away on this thread, which owns the context, so whatever the caller draws next still
+		// lands after the meshes
+		Flush();
+		if (!s_Data.CommandBuffer->IsEmpty())
+		{
+			RenderCommandQueue::Submit(s_Data.CommandBuffer);
+			RenderCommandQueue::Flush();
+		}
+
+		s_Data.Commands.clear();
+		GPUProfiler::EndScope();
+	}
+
+	void Renderer3D::SubmitMesh(const Mesh& mesh, const glm::mat4& transform, int entityID, const Ref<Shader>& shader)
+	{
+		if (!mesh.m_VertexArray)
+			return;
+
+		Shader* meshShader = shader ? shader.get() : s_Data.MeshShader.get();
+		uint32_t lod = SelectLod(mesh, transform);
+
+		// Vertex arrays have no stable ID of their own, so the low bits of their address group them
+		uint64_t sortKey = (uint64_t)meshShader->GetRendererID() << 40 | ((uint64_t)(uintptr_t)mesh.m_VertexArray.get() & 0xFFFFFFFF) << 8 | lod;
+		s_Data.Commands.push_back({ sortKey, mesh.m_VertexArray, &mesh, lod, meshShader, transform, entityID });
+
+		s_Data.Stats.MeshCount++;
+		for (uint32_t i = 0; i < (uint32_t)mesh.GetSubmeshes().size(); i++)
+			s_Data.Stats.TriangleCount += mesh.GetLodRange(lod, i).IndexCount / 3;
+	}
+
+	uint32_t Renderer3D::SelectLod(const Mesh& mesh, const glm::mat4& transform)
+	{
+		uint32_t lodCount = mesh.GetLodCount();
+		if (lodCount <= 1)
+			return 0;
+
+		float scale = std::max(glm::length(glm::vec3(transform[0])), std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+		float radius = mesh.GetBoundingRadius() * scale;
+
+		// Radius of the bounding sphere on screen, in normalized device coordinates
+		float projectedRadius = radius * s_Data.ProjectionScale;
+		if (s_Data.Perspective)
+		{
+			float distance = -(s_Data.View * transform * glm::vec4(mesh.GetBoundingCenter(), 1.0f)).z;
+			if (distance <= radius)
+				return 0;
+			projectedRadius /= distance;
+		}
+
+		uint32_t lod = lodCount - 1;
+		while (lod > 0 && mesh.GetLodError(lod) * projectedRadius > LodErrorThreshold)
+			lod--;
+		return lod;
 	}
-	void Renderer3D::SubmitMesh(Mesh& mesh, glm::mat4 transform, int entityID)
+
+	void Renderer3D::Flush()
 	{
-		std::dynamic_pointer_cast<OpenGLShader>(m_MeshShader)->UploadUniformMat4("u_ViewProjection", m_SceneData.ViewProjectionMatrix);
-		glm::mat4 model = glm::mat4(1.0f);
-		std::dynamic_pointer_cast<OpenGLShader>(m_MeshShader)->UploadUniformMat4("u_Transform", model);
+		auto& commands = s_Data.Commands;
+		if (commands.empty())
+			return;
+
+		// Everything the draws need goes into the command buffer, including the camera, so the replay does not
+		// depend on uniform buffer contents changed after recording
+		RenderCommandBuffer& buffer = *s_Data.CommandBuffer;
+		buffer.Record([]() { GPUProfiler::BeginScope("Renderer3D Flush"); });
+		buffer.SetUniformBufferData(s_Data.CameraUniformBuffer, &s_Data.CameraBuffer, sizeof(Renderer3DData::CameraData));
+
+		std::stable_sort(commands.begin(), commands.end(), [](const MeshCommand& a, const MeshCommand& b) { return a.SortKey < b.SortKey; });
+
+		// Sorting left meshes sharing a vertex array and shader next to each other, and their objects are
+		// consecutive in the batch, so each run of one mesh at one LOD is an instanced draw per submesh. The base
+		// instance offsets a_ObjectIndex. Runs sharing a vertex array and shader within a batch form one multi-draw
+		auto& indirectCommands = s_Data.IndirectCommands;
+		auto& groups = s_Data.IndirectGroups;
+		indirectCommands.clear();
+		groups.clear();
+
+		for (uint32_t batchBegin = 0; batchBegin < (uint32_t)commands.size(); batchBegin += MaxObjectsPerBatch)
+		{
+			uint32_t batch = batchBegin / MaxObjectsPerBatch;
+			uint32_t batchCount = std::min(MaxObjectsPerBatch, (uint32_t)commands.size() - batchBegin);
+
+			for (uint32_t runBegin = 0; runBegin < batchCount;)
+			{
+				const MeshCommand& command = commands[batchBegin + runBegin];
+
+				uint32_t runEnd = runBegin + 1;
+				while (runEnd < batchCount && commands[batchBegin + runEnd].SortKey == command.SortKey
+					&& commands[batchBegin + runEnd].MeshVertexArray == command.MeshVertexArray)
+					runEnd++;
+
+				if (groups.empty() || groups.back().Batch != batch || groups.back().GroupVertexArray != command.MeshVertexArray
+					|| groups.back().GroupShader != command.MeshShader)
+					groups.push_back({ (uint32_t)indirectCommands.size(), 0, batch, command.MeshVertexArray, command.MeshShader });
+
+				const auto& submeshes = command.MeshSource->GetSubmeshes();
+				for (uint32_t i = 0; i < (uint32_t)submeshes.size(); i++)
+				{
+					const Mesh::IndexRange& range = command.MeshSource->GetLodRange(command.Lod, i);
+					if (range.IndexCount == 0)
+						continue;
+
+					indirectCommands.push_back({ range.IndexCount, runEnd - runBegin, range.IndexOffset, (int32_t)submeshes[i].BaseVertex, runBegin });
+					groups.back().CommandCount++;
+				}
+				runBegin = runEnd;
+			}
+		}
+
+		// Every command of the frame goes up in one upload
+		uint32_t indirectSize = (uint32_t)(indirectCommands.size() * sizeof(DrawIndexedIndirectCommand));
+		if (indirectSize > s_Data.IndirectCommandBuffer->GetSize())
+			s_Data.IndirectCommandBuffer = IndirectBuffer::Create(std::max(indirectSize, 2 * s_Data.IndirectCommandBuffer->GetSize()));
+		buffer.SetIndirectBufferData(s_Data.IndirectCommandBuffer, indirectCommands.data(), indirectSize);
+
+		const Shader* boundShader = nullptr;
+		size_t group = 0;
+		for (uint32_t batchBegin = 0; batchBegin < (uint32_t)commands.size(); batchBegin += MaxObjectsPerBatch)
+		{
+			uint32_t batch = batchBegin / MaxObjectsPerBatch;
+			uint32_t batchCount = std::min(MaxObjectsPerBatch, (uint32_t)commands.size() - batchBegin);
+
+			for (uint32_t i = 0; i < batchCount; i++)
+			{
+				const MeshCommand& command = commands[batchBegin + i];
+				s_Data.ObjectBuffer.Transforms[i] = command.Transform;
+				s_Data.ObjectBuffer.EntityIDs[i / 4][i % 4] = command.EntityID;
+			}
+			buffer.SetUniformBufferData(s_Data.ObjectUniformBuffer, &s_Data.ObjectBuffer.Transforms, batchCount * sizeof(glm::mat4));
+			buffer.SetUniformBufferData(s_Data.ObjectUniformBuffer, &s_Data.ObjectBuffer.EntityIDs, (batchCount + 3) / 4 * sizeof(glm::ivec4), offsetof(Renderer3DData::ObjectData, EntityIDs));
+
+			for (; group < groups.size() && groups[group].Batch == batch; group++)
+			{
+				const IndirectGroup& indirectGroup = groups[group];
+				if (indirectGroup.CommandCount == 0)
+					continue;
+
+				if (indirectGroup.GroupShader != boundShader)
+				{
+					// Submitted shaders are kept alive by their callers until EndScene, which waits for the replay
+					const Shader* shader = indirectGroup.GroupShader;
+					buffer.Record([shader]() { shader->Bind(); });
+					boundShader = shader;
+				}
 
-		m_MeshShader->Bind();
-		mesh.m_VertexArray->Bind();
-		RenderCommand::DrawIndexed(mesh.m_VertexArray);
+				buffer.DrawIndexedIndirect(indirectGroup.GroupVertexArray, s_Data.IndirectCommandBuffer, indirectGroup.CommandCount, indirectGroup.FirstCommand);
+				s_Data.Stats.DrawCalls++;
+				s_Data.Stats.IndirectDrawCount += indirectGroup.CommandCount;
+			}
+		}
+
+		buffer.Record([]() { GPUProfiler::EndScope(); });
+	}
+
+	const Math::Frustum& Renderer3D::GetFrustum()
+	{
+		return s_Data.Frustum;
+	}
+
+	const glm::mat4& Renderer3D::GetViewProjection()
+	{
+		return s_Data.CameraBuffer.ViewProjection;
+	}
+
+	void Renderer3D::AddCulledMeshes(uint32_t count)
+	{
+		s_Data.Stats.CulledMeshCount += count;
+	}
+
+	void Renderer3D::AddOccludedMeshes(uint32_t count)
+	{
+		s_Data.Stats.OccludedMeshCount += count;
+	}
+
+	void Renderer3D::ResetStats()
+	{
+		memset(&s_Data.Stats, 0, sizeof(Statistics));
+	}
+
+	Renderer3D::Statistics Renderer3D::GetStats()
+	{
+		return s_Data.Stats;
 	}
 }
\ No newline at end of file
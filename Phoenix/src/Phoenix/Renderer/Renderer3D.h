@@ -6,6 +6,8 @@
 #include "Phoenix/Renderer/Texture.h"
 #include "Phoenix/Renderer/Shader.h"
 
+#include "Phoenix/Math/Frustum.h"
+
 #include "Phoenix/Scene/Components.h"
 
 namespace phx {
@@ -18,16 +20,21 @@ namespace phx {
 		float TilingFactor = 1.0f;
 		int EntityID = 1;
 	};
-	struct SceneData
-	{
-		glm::mat4 ViewProjectionMatrix;
-	};
-	static SceneData m_SceneData;
-	static Ref<Shader> m_MeshShader;
 
+	// Meshes are queued between BeginScene and EndScene. EndScene sorts the queue by shader and mesh, writes the
+	// transforms and entity IDs of up to MaxObjectsPerBatch meshes into one uniform buffer upload, and turns every
+	// run of the same mesh and shader into one instanced indirect command per submesh, with object indices passed
+	// through the base instance. All commands of a batch sharing a vertex array and shader go out as one multi-draw,
+	// so draw calls scale with unique vertex arrays per batch rather than with submissions or submeshes. The uploads
+	// and draws are recorded into a RenderCommandBuffer and replayed before EndScene returns.
+	// Each submission draws the coarsest LOD whose error, projected with the camera given to BeginScene, stays under
+	// LodErrorThreshold. The projection scales the mesh's bounding sphere by its distance from the camera
 	class Renderer3D
 	{
 	public:
+		static constexpr uint32_t MaxObjectsPerBatch = 128; // Matches the Objects block of the mesh shader
+		static constexpr float LodErrorThreshold = 0.002f; // In normalized device coordinates, about a pixel at 1080p
+
 		static void Init();
 
 		static void BeginScene(const OrthographicCamera& camera);
@@ -36,8 +43,32 @@ namespace phx {
 
 		static void EndScene();
 
-		static void SubmitMesh(Mesh& mesh, glm::mat4 transform, int entityID);
-	private:
+		// The shader stands in for a material, nullptr uses the default mesh shader
+		static void SubmitMesh(const Mesh& mesh, const glm::mat4& transform, int entityID, const Ref<Shader>& shader = nullptr);
+
+		// Per-instance a_ObjectIndex attribute every mesh vertex array binds after its vertex attributes
+		static const Ref<VertexBuffer>& GetObjectIndexBuffer();
 
+		// Frustum of the camera given to BeginScene. Culling happens before submission, see Scene::Render3D
+		static const Math::Frustum& GetFrustum();
+		static const glm::mat4& GetViewProjection();
+		static void AddCulledMeshes(uint32_t count);
+		static void AddOccludedMeshes(uint32_t count);
+
+		struct Statistics
+		{
+			uint32_t DrawCalls = 0;
+			uint32_t IndirectDrawCount = 0; // Draws inside the multi-draws
+			uint32_t MeshCount = 0; // Submitted, so visible
+			uint32_t CulledMeshCount = 0; // Outside the frustum
+			uint32_t OccludedMeshCount = 0; // Inside the frustum, hidden behind occluders
+			uint32_t TriangleCount = 0;
+		};
+		static Statistics GetStats();
+		static void ResetStats();
+	private:
+		static void SetCamera(const glm::mat4& projection, const glm::mat4& view);
+		static uint32_t SelectLod(const Mesh& mesh, const glm::mat4& transform);
+		static void Flush();
 	};
 }
\ No newline at end of file
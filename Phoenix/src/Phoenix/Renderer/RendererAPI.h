@@ -37,10 +37,24 @@ namespace phx {
 
 		virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
 		virtual void DrawIndexed(unsigned int count) = 0;
+		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0, uint32_t firstIndex = 0) = 0;
+		// Draws drawCount DrawIndexedIndirectCommands read from the buffer, starting at command firstDraw
+		virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t firstDraw = 0) = 0;
 
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0) = 0;
 
 		virtual void SetLineWidth(float width) = 0;
+		// Maps normalized device depth onto [nearDepth, farDepth] of the depth buffer
+		virtual void SetDepthRange(float nearDepth, float farDepth) = 0;
+
+		// State changes requested of the backend, and how many were skipped because they would not change anything
+		struct StateStatistics
+		{
+			uint32_t IssuedCalls = 0;
+			uint32_t ElidedCalls = 0;
+		};
+		virtual StateStatistics GetStateStats() const = 0;
+		virtual void ResetStateStats() = 0;
 
 		static API getAPI() { return s_API; }
 	private:
@@ -25,7 +25,21 @@ namespace phx {
 		virtual void SetVec4(const std::string& name, const glm::vec4& value) = 0;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) = 0;
 
+		// A uniform's location, resolved once so hot paths skip the name lookup. Uniforms the shader does not use
+		// resolve to -1, and setting them does nothing. The shader must be bound when setting a uniform
+		using UniformHandle = int32_t;
+		virtual UniformHandle GetUniformHandle(const std::string& name) const = 0;
+
+		virtual void SetInt(UniformHandle handle, int value) = 0;
+		virtual void SetIntArray(UniformHandle handle, int* values, uint32_t count) = 0;
+		virtual void SetFloat(UniformHandle handle, float value) = 0;
+		virtual void SetVec2(UniformHandle handle, const glm::vec2& value) = 0;
+		virtual void SetVec3(UniformHandle handle, const glm::vec3& value) = 0;
+		virtual void SetVec4(UniformHandle handle, const glm::vec4& value) = 0;
+		virtual void SetMat4(UniformHandle handle, const glm::mat4& value) = 0;
+
 		virtual const std::string& GetName() const = 0;
+		virtual uint32_t GetRendererID() const = 0;
 
 		static Ref<Shader> Create(const std::string& filepath);
 		static Ref<Shader> Create(const std::string& name, const std::string& filepathVertex, const std::string& filepathFragment);
@@ -28,4 +28,28 @@ namespace phx {
 		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
+
+	Ref<Texture2DArray> Texture2DArray::Create(uint32_t width, uint32_t height, uint32_t layers)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:    PHX_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLTexture2DArray>(width, height, layers);
+		}
+
+		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	Ref<IndexTexture2D> IndexTexture2D::Create(uint32_t width, uint32_t height)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:    PHX_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLIndexTexture2D>(width, height);
+		}
+
+		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
 }
\ No newline at end of file
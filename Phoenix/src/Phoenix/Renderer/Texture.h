@@ -20,6 +20,11 @@ namespace phx {
 		virtual std::string GetPath() const = 0;
 
 		virtual bool IsLoaded() const = 0;
+		virtual bool HasAlphaChannel() const = 0;
+		// Whether any texel of the data set so far has alpha below one
+		virtual bool IsTranslucent() const = 0;
+		// Bumped by every SetData, so copies of the texels can tell they are stale
+		virtual uint32_t GetVersion() const = 0;
 	};
 
 	class Texture2D : public Texture
@@ -31,6 +36,45 @@ namespace phx {
 		virtual bool operator==(const Texture& other) const = 0;
 	};
 
+	// Stack of equally sized RGBA8 layers sampled through a single texture unit
+	class Texture2DArray
+	{
+	public:
+		virtual ~Texture2DArray() = default;
+
+		virtual uint32_t GetWidth() const = 0;
+		virtual uint32_t GetHeight() const = 0;
+		virtual uint32_t GetLayerCount() const = 0;
+		virtual uint32_t GetRendererID() const = 0;
+
+		// Copies the whole of texture into layer, converting its format if needed. Sizes must match
+		virtual void CopyToLayer(const Ref<Texture2D>& texture, uint32_t layer) = 0;
+		// Copies the first layerCount layers of source into this array. Sizes must match
+		virtual void CopyLayers(const Ref<Texture2DArray>& source, uint32_t layerCount) = 0;
+
+		virtual void Bind(uint32_t slot = 0) const = 0;
+
+		static Ref<Texture2DArray> Create(uint32_t width, uint32_t height, uint32_t layers);
+	};
+
+	// Single channel 16-bit unsigned integer texture, read unfiltered with texelFetch
+	class IndexTexture2D
+	{
+	public:
+		virtual ~IndexTexture2D() = default;
+
+		virtual uint32_t GetWidth() const = 0;
+		virtual uint32_t GetHeight() const = 0;
+		virtual uint32_t GetRendererID() const = 0;
+
+		// Uploads width * height indices, row by row starting from the bottom
+		virtual void SetData(const uint16_t* data) = 0;
+
+		virtual void Bind(uint32_t slot = 0) const = 0;
+
+		static Ref<IndexTexture2D> Create(uint32_t width, uint32_t height);
+	};
+
 	class Texture3D : public Texture
 	{
 	public:
@@ -0,0 +1,21 @@
+#include "phxpch.h"
+#include "TimestampQueryPool.h"
+
+#include "Phoenix/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLTimestampQueryPool.h"
+
+namespace phx {
+
+	Ref<TimestampQueryPool> TimestampQueryPool::Create(uint32_t capacity)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:    PHX_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLTimestampQueryPool>(capacity);
+		}
+
+		PHX_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Phoenix/Application/Base.h"
+
+namespace phx {
+
+	// Fixed set of GPU timestamps, written in order and read back once the GPU has passed the last one. Unlike
+	// elapsed time queries, timestamps may be taken inside each other, so nested passes can all be timed
+	class TimestampQueryPool
+	{
+	public:
+		static constexpr uint32_t InvalidQuery = ~0u;
+
+		virtual ~TimestampQueryPool() {}
+
+		// Records the GPU time at which the commands issued so far are done. InvalidQuery when the pool is full
+		virtual uint32_t Write() = 0;
+		virtual uint32_t GetWrittenCount() const = 0;
+		// Copies the written timestamps, in nanoseconds, without waiting. False while the GPU has not reached them
+		virtual bool TryRead(uint64_t* outNanoseconds) = 0;
+		// Forgets the written timestamps so the queries can be taken again
+		virtual void Reset() = 0;
+
+		// The GPU clock right now, in nanoseconds, to line timestamps up with the CPU clock
+		virtual uint64_t GetCurrentTimestamp() const = 0;
+
+		static Ref<TimestampQueryPool> Create(uint32_t capacity);
+	};
+
+}
\ No newline at end of file
@@ -13,6 +13,8 @@ namespace phx {
 		virtual void Unbind() const = 0;
 
 		virtual void AddVertexBuffer(const phx::Ref<VertexBuffer>& vertexBuffer) = 0;
+		// Attributes of an instance buffer advance once per instance instead of once per vertex
+		virtual void AddInstanceBuffer(const phx::Ref<VertexBuffer>& instanceBuffer) = 0;
 		virtual void SetIndexBuffer(const phx::Ref<IndexBuffer>& indexBuffer) = 0;
 
 		virtual const std::vector<phx::Ref<VertexBuffer>>& GetVertexBuffers() const = 0;
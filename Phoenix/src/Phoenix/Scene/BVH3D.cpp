@@ -0,0 +1,112 @@
+#include "phxpch.h"
+#include "BVH3D.h"
+
+namespace phx {
+
+	void BVH3D::Build(std::vector<Item> items)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		m_Items = std::move(items);
+		m_Nodes.clear();
+		if (m_Items.empty())
+			return;
+
+		m_Nodes.reserve(2 * m_Items.size() / MaxLeafSize + 1);
+		m_Nodes.push_back({});
+		BuildNode(0, 0, (uint32_t)m_Items.size());
+	}
+
+	void BVH3D::Clear()
+	{
+		m_Nodes.clear();
+		m_Items.clear();
+	}
+
+	void BVH3D::BuildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end)
+	{
+		Math::AABB bounds = m_Items[begin].Bounds;
+		Math::AABB centers = { bounds.GetCenter(), bounds.GetCenter() };
+		for (uint32_t i = begin + 1; i < end; i++)
+		{
+			bounds.Grow(m_Items[i].Bounds);
+			glm::vec3 center = m_Items[i].Bounds.GetCenter();
+			centers.Grow({ center, center });
+		}
+		m_Nodes[nodeIndex].Bounds = bounds;
+
+		glm::vec3 spread = centers.Max - centers.Min;
+		if (end - begin <= MaxLeafSize || (spread.x == 0.0f && spread.y == 0.0f && spread.z == 0.0f))
+		{
+			m_Nodes[nodeIndex].First = begin;
+			m_Nodes[nodeIndex].Count = end - begin;
+			return;
+		}
+
+		int axis = spread.x >= spread.y && spread.x >= spread.z ? 0 : spread.y >= spread.z ? 1 : 2;
+		uint32_t middle = begin + (end - begin) / 2;
+		std::nth_element(m_Items.begin() + begin, m_Items.begin() + middle, m_Items.begin() + end, [axis](const Item& a, const Item& b)
+		{
+			return a.Bounds.Min[axis] + a.Bounds.Max[axis] < b.Bounds.Min[axis] + b.Bounds.Max[axis];
+		});
+
+		// Children are appended before recursing, which invalidates references into m_Nodes
+		uint32_t left = (uint32_t)m_Nodes.size();
+		m_Nodes.push_back({});
+		BuildNode(left, begin, middle);
+
+		uint32_t right = (uint32_t)m_Nodes.size();
+		m_Nodes.push_back({});
+		BuildNode(right, middle, end);
+
+		m_Nodes[nodeIndex].First = right;
+		m_Nodes[nodeIndex].Count = 0;
+	}
+
+	void BVH3D::Query(const Math::Frustum& frustum, std::vector<uint32_t>& outIDs) const
+	{
+		PHX_PROFILE_FUNCTION();
+
+		if (m_Nodes.empty())
+			return;
+
+		struct Entry
+		{
+			uint32_t Node;
+			bool Inside; // An ancestor was fully inside the frustum
+		};
+
+		Entry stack[64];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = { 0, false };
+
+		while (stackSize > 0)
+		{
+			Entry entry = stack[--stackSize];
+			const Node& node = m_Nodes[entry.Node];
+
+			bool inside = entry.Inside;
+			if (!inside)
+			{
+				Math::Frustum::Result result = frustum.Classify(node.Bounds);
+				if (result == Math::Frustum::Result::Outside)
+					continue;
+				inside = result == Math::Frustum::Result::Inside;
+			}
+
+			if (node.Count > 0)
+			{
+				for (uint32_t i = node.First; i < node.First + node.Count; i++)
+				{
+					if (inside || frustum.Intersects(m_Items[i].Bounds))
+						outIDs.push_back(m_Items[i].ID);
+				}
+				continue;
+			}
+
+			stack[stackSize++] = { node.First, inside };
+			stack[stackSize++] = { entry.Node + 1, inside };
+		}
+	}
+
+}
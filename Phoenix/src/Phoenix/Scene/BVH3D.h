@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Phoenix/Math/AABB.h"
+#include "Phoenix/Math/Frustum.h"
+
+#include <vector>
+
+namespace phx {
+
+	// Bounding volume hierarchy over 3D bounds keyed by ID, built in one go for items that rarely move. Nodes split
+	// at the median of their longest axis until MaxLeafSize items are left. Queries skip whole subtrees outside the
+	// frustum and accept whole subtrees inside it without testing their items.
+	class BVH3D
+	{
+	public:
+		struct Item
+		{
+			uint32_t ID;
+			Math::AABB Bounds;
+		};
+
+		static constexpr uint32_t MaxLeafSize = 4;
+
+		// Replaces the current contents
+		void Build(std::vector<Item> items);
+		void Clear();
+
+		uint32_t GetCount() const { return (uint32_t)m_Items.size(); }
+
+		// Appends the IDs of every item overlapping the frustum, in no particular order
+		void Query(const Math::Frustum& frustum, std::vector<uint32_t>& outIDs) const;
+	private:
+		struct Node
+		{
+			Math::AABB Bounds;
+			uint32_t First; // First item of a leaf, second child of an inner node. The first child follows its parent
+			uint32_t Count; // Items of a leaf, 0 for inner nodes
+		};
+
+		void BuildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end);
+	private:
+		std::vector<Node> m_Nodes;
+		std::vector<Item> m_Items;
+	};
+
+}
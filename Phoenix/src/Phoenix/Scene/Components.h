@@ -5,7 +5,9 @@
 #include "Phoenix/Application/UUID.h"
 
 #include "Phoenix/Renderer/Texture.h"
-#include "Phoenix/Renderer/Mesh.h"
+#include "Phoenix/Renderer/MeshCache.h"
+
+#include "Phoenix/Scene/ParticlePool.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "../vendor/glm/glm/glm.hpp"
@@ -59,6 +61,8 @@ namespace phx {
 		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
 		Ref<Texture2D> Texture; 
 		float TilingFactor = 1.0f;
+		int SortingLayer = 0; // 0-255, higher layers draw on top
+		bool Static = false; // Baked into the scene's static batch and drawn beneath dynamic sprites
 
 		std::string Path = std::string();
 
@@ -73,11 +77,143 @@ namespace phx {
 		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
 		float Thickness = 1.0f;
 		float Fade = 0.005f;
+		int SortingLayer = 0; // 0-255, higher layers draw on top
 
 		CircleRendererComponent() = default;
 		CircleRendererComponent(const CircleRendererComponent&) = default;
 	};
 
+	// Grid of tiles stored in square chunks, each drawn as a single quad that looks its tiles up in an index texture.
+	// Tile 0 is empty, tile n shows cell n - 1 of the atlas, counting left to right from the top-left cell.
+	// Tile (0, 0) is the bottom-left one, and the map extends along +X and +Y from the entity's origin
+	struct TilemapComponent
+	{
+		static constexpr uint32_t ChunkSize = 32;
+
+		struct Chunk
+		{
+			std::vector<uint16_t> Tiles = std::vector<uint16_t>(ChunkSize * ChunkSize, 0);
+			uint32_t TileCount = 0; // Non-empty tiles, empty chunks are skipped
+
+			// Created and refreshed by the renderer. Copies get their own texture so they can be edited separately
+			Ref<IndexTexture2D> IndexTexture;
+			bool Dirty = true;
+
+			Chunk() = default;
+			Chunk(const Chunk& other)
+				: Tiles(other.Tiles), TileCount(other.TileCount) {}
+			Chunk& operator=(const Chunk& other)
+			{
+				Tiles = other.Tiles;
+				TileCount = other.TileCount;
+				IndexTexture = nullptr;
+				Dirty = true;
+				return *this;
+			}
+		};
+
+		Ref<Texture2D> Atlas;
+		int AtlasColumns = 1;
+		int AtlasRows = 1;
+		glm::vec2 TileSize = { 1.0f, 1.0f };
+		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+		std::string Path = std::string();
+
+		TilemapComponent() = default;
+		TilemapComponent(const TilemapComponent&) = default;
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		uint32_t GetChunkColumns() const { return m_ChunkColumns; }
+		uint32_t GetChunkRows() const { return m_ChunkRows; }
+
+		std::vector<Chunk>& GetChunks() { return m_Chunks; }
+		const std::vector<Chunk>& GetChunks() const { return m_Chunks; }
+
+		// Keeps the tiles that still fit
+		void Resize(uint32_t width, uint32_t height)
+		{
+			TilemapComponent resized;
+			resized.m_Width = width;
+			resized.m_Height = height;
+			resized.m_ChunkColumns = (width + ChunkSize - 1) / ChunkSize;
+			resized.m_ChunkRows = (height + ChunkSize - 1) / ChunkSize;
+			resized.m_Chunks.resize((size_t)resized.m_ChunkColumns * resized.m_ChunkRows);
+
+			for (uint32_t y = 0; y < std::min(height, m_Height); y++)
+				for (uint32_t x = 0; x < std::min(width, m_Width); x++)
+					resized.SetTile(x, y, GetTile(x, y));
+
+			m_Width = width;
+			m_Height = height;
+			m_ChunkColumns = resized.m_ChunkColumns;
+			m_ChunkRows = resized.m_ChunkRows;
+			m_Chunks = std::move(resized.m_Chunks);
+		}
+
+		uint16_t GetTile(uint32_t x, uint32_t y) const
+		{
+			if (x >= m_Width || y >= m_Height)
+				return 0;
+
+			const Chunk& chunk = m_Chunks[(y / ChunkSize) * m_ChunkColumns + x / ChunkSize];
+			return chunk.Tiles[(y % ChunkSize) * ChunkSize + x % ChunkSize];
+		}
+
+		// Only the chunk holding the tile is uploaded again
+		void SetTile(uint32_t x, uint32_t y, uint16_t tile)
+		{
+			if (x >= m_Width || y >= m_Height)
+				return;
+
+			Chunk& chunk = m_Chunks[(y / ChunkSize) * m_ChunkColumns + x / ChunkSize];
+			uint16_t& current = chunk.Tiles[(y % ChunkSize) * ChunkSize + x % ChunkSize];
+			if (current == tile)
+				return;
+
+			if (current == 0)
+				chunk.TileCount++;
+			else if (tile == 0)
+				chunk.TileCount--;
+			current = tile;
+			chunk.Dirty = true;
+		}
+	private:
+		uint32_t m_Width = 0, m_Height = 0;
+		uint32_t m_ChunkColumns = 0, m_ChunkRows = 0;
+		std::vector<Chunk> m_Chunks;
+	};
+
+	// Emits world-space particles from the entity's position at runtime. Particles are not entities: they live in
+	// the pool and are drawn straight into Renderer2D's batches
+	struct ParticleEmitterComponent
+	{
+		float EmissionRate = 100.0f; // Particles per second
+		uint32_t MaxParticles = 10000;
+		bool Emitting = true;
+
+		float Lifetime = 1.0f;
+		float LifetimeVariation = 0.25f;
+		glm::vec2 Velocity = { 0.0f, 1.0f };
+		glm::vec2 VelocityVariation = { 1.0f, 1.0f };
+		float AngularVelocity = 0.0f;
+		float AngularVelocityVariation = 0.0f;
+
+		ParticleUpdateParams Update;
+
+		Ref<Texture2D> Texture;
+		std::string Path = std::string();
+		int SortingLayer = 0; // 0-255, higher layers draw on top
+
+		// Storage for runtime
+		ParticlePool Pool;
+		float EmissionAccumulator = 0.0f;
+
+		ParticleEmitterComponent() = default;
+		ParticleEmitterComponent(const ParticleEmitterComponent&) = default;
+	};
+
 	struct CameraComponent
 	{
 		SceneCamera Camera;
@@ -167,13 +303,16 @@ namespace phx {
 
 
 
+	// Holds a handle to a mesh shared through the MeshCache, copies share the geometry
 	struct MeshComponent
 	{
-		Mesh Mesh;
+		Ref<phx::Mesh> Mesh;
 		std::string Path = std::string();
+		bool Static = false; // Kept in the scene's BVH for culling, which is rebuilt when a static mesh moves
+		bool Occluder = false; // Rasterized on the CPU each frame to hide the meshes behind it, best for large walls and floors
 
 		MeshComponent() = default;
 		MeshComponent(const MeshComponent&) = default;
-		MeshComponent(const std::string filepath) : Mesh(phx::Mesh(filepath)), Path(std::filesystem::path(filepath).string()) {}
+		MeshComponent(const std::string& filepath) : Mesh(MeshCache::Load(filepath)), Path(std::filesystem::path(filepath).string()) {}
 	};
 }
\ No newline at end of file
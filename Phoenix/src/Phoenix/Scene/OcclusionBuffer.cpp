@@ -0,0 +1,244 @@
+#include "phxpch.h"
+#include "OcclusionBuffer.h"
+
+#include "Phoenix/Math/SIMDLanes.h"
+#include "Phoenix/Threading/JobSystem.h"
+
+namespace phx {
+
+	static constexpr uint32_t TileColumns = OcclusionBuffer::Width / OcclusionBuffer::TileWidth;
+	static constexpr uint32_t TileRows = OcclusionBuffer::Height / OcclusionBuffer::TileHeight;
+	static constexpr float MinClipW = 1e-4f;
+
+	static_assert(OcclusionBuffer::Width % OcclusionBuffer::TileWidth == 0 && OcclusionBuffer::Height % OcclusionBuffer::TileHeight == 0);
+	static_assert(OcclusionBuffer::TileWidth % Math::SIMDLanes::Width == 0);
+
+	OcclusionBuffer::OcclusionBuffer()
+		: m_Depth((size_t)Width * Height, 1.0f), m_TileMaxDepth((size_t)TileColumns * TileRows, 1.0f)
+	{
+	}
+
+	void OcclusionBuffer::Begin(const glm::mat4& viewProjection)
+	{
+		m_ViewProjection = viewProjection;
+		m_Occluders.clear();
+		m_TriangleCount = 0;
+		std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+		std::fill(m_TileMaxDepth.begin(), m_TileMaxDepth.end(), 1.0f);
+	}
+
+	void OcclusionBuffer::AddOccluder(const glm::vec3* positions, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, const glm::mat4& transform)
+	{
+		if (indexCount >= 3)
+			m_Occluders.push_back({ positions, vertexCount, indices, indexCount, transform });
+	}
+
+	void OcclusionBuffer::Rasterize()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		uint32_t threadCount = JobSystem::GetThreadCount();
+		m_ThreadTriangles.resize(threadCount);
+		m_ThreadClip.resize(threadCount);
+		for (auto& triangles : m_ThreadTriangles)
+			triangles.clear();
+
+		JobSystem::ParallelFor((uint32_t)m_Occluders.size(), 1, [this](uint32_t begin, uint32_t end, uint32_t threadIndex)
+		{
+			for (uint32_t i = begin; i < end; i++)
+				SetupOccluder(m_Occluders[i], m_ThreadClip[threadIndex], m_ThreadTriangles[threadIndex]);
+		});
+
+		m_TriangleCount = 0;
+		for (const auto& triangles : m_ThreadTriangles)
+			m_TriangleCount += (uint32_t)triangles.size();
+		if (m_TriangleCount == 0)
+			return;
+
+		JobSystem::ParallelFor(TileRows, 1, [this](uint32_t begin, uint32_t end, uint32_t)
+		{
+			for (uint32_t band = begin; band < end; band++)
+				RasterizeBand(band);
+		});
+	}
+
+	void OcclusionBuffer::SetupOccluder(const Occluder& occluder, std::vector<glm::vec4>& screen, std::vector<ScreenTriangle>& outTriangles) const
+	{
+		glm::mat4 transform = m_ViewProjection * occluder.Transform;
+
+		// Pixel coordinates, depth in [0, 1] and clip w, which marks vertices behind the near plane
+		screen.resize(occluder.VertexCount);
+		for (uint32_t i = 0; i < occluder.VertexCount; i++)
+		{
+			glm::vec4 clip = transform * glm::vec4(occluder.Positions[i], 1.0f);
+			if (clip.w <= MinClipW)
+			{
+				screen[i] = { 0.0f, 0.0f, 0.0f, clip.w };
+				continue;
+			}
+
+			glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			screen[i] = { (ndc.x * 0.5f + 0.5f) * Width, (ndc.y * 0.5f + 0.5f) * Height, ndc.z * 0.5f + 0.5f, clip.w };
+		}
+
+		for (uint32_t i = 0; i + 2 < occluder.IndexCount; i += 3)
+		{
+			glm::vec4 v[3] = { screen[occluder.Indices[i]], screen[occluder.Indices[i + 1]], screen[occluder.Indices[i + 2]] };
+
+			// Dropping triangles that cross the near plane only leaves holes, so occlusion stays conservative
+			if (v[0].w <= MinClipW || v[1].w <= MinClipW || v[2].w <= MinClipW || v[0].z < 0.0f || v[1].z < 0.0f || v[2].z < 0.0f)
+				continue;
+
+			// Both windings are drawn, occluders need not be closed
+			float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+			if (area == 0.0f)
+				continue;
+			if (area < 0.0f)
+			{
+				std::swap(v[1], v[2]);
+				area = -area;
+			}
+
+			// Pixels are covered when their center is inside
+			ScreenTriangle triangle;
+			triangle.MinX = std::max((int)std::ceil(std::min(v[0].x, std::min(v[1].x, v[2].x)) - 0.5f), 0);
+			triangle.MaxX = std::min((int)std::floor(std::max(v[0].x, std::max(v[1].x, v[2].x)) - 0.5f), (int)Width - 1);
+			triangle.MinY = std::max((int)std::ceil(std::min(v[0].y, std::min(v[1].y, v[2].y)) - 0.5f), 0);
+			triangle.MaxY = std::min((int)std::floor(std::max(v[0].y, std::max(v[1].y, v[2].y)) - 0.5f), (int)Height - 1);
+			if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+				continue;
+
+			// Edge i runs from vertex i to the next one, and its value over the area is the weight of the vertex
+			// opposite it
+			triangle.DepthX = triangle.DepthY = triangle.Depth0 = 0.0f;
+			for (int e = 0; e < 3; e++)
+			{
+				const glm::vec4& a = v[e];
+				const glm::vec4& b = v[(e + 1) % 3];
+				float opposite = v[(e + 2) % 3].z / area;
+
+				triangle.EdgeA[e] = a.y - b.y;
+				triangle.EdgeB[e] = b.x - a.x;
+				triangle.EdgeC[e] = -(triangle.EdgeA[e] * a.x + triangle.EdgeB[e] * a.y);
+				triangle.DepthX += triangle.EdgeA[e] * opposite;
+				triangle.DepthY += triangle.EdgeB[e] * opposite;
+				triangle.Depth0 += triangle.EdgeC[e] * opposite;
+			}
+			outTriangles.push_back(triangle);
+		}
+	}
+
+	void OcclusionBuffer::RasterizeBand(uint32_t band)
+	{
+		using L = Math::SIMDLanes;
+		using V = L::Type;
+
+		static const float PixelCenters[8] = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+		const V centers = L::LoadUnaligned(PixelCenters);
+		const V zero = L::Set(0.0f);
+
+		int bandBegin = (int)(band * TileHeight);
+		int bandEnd = bandBegin + (int)TileHeight - 1;
+
+		for (const auto& triangles : m_ThreadTriangles)
+		{
+			for (const ScreenTriangle& triangle : triangles)
+			{
+				if (triangle.MaxY < bandBegin || triangle.MinY > bandEnd)
+					continue;
+
+				const V edgeA0 = L::Set(triangle.EdgeA[0]), edgeA1 = L::Set(triangle.EdgeA[1]), edgeA2 = L::Set(triangle.EdgeA[2]);
+				const V depthX = L::Set(triangle.DepthX);
+
+				// Rows start on a register boundary, pixels past the triangle's bounds fail the edge test
+				int xBegin = triangle.MinX / (int)L::Width * (int)L::Width;
+				for (int y = std::max(triangle.MinY, bandBegin); y <= std::min(triangle.MaxY, bandEnd); y++)
+				{
+					float py = y + 0.5f;
+					const V rowEdge0 = L::Set(triangle.EdgeB[0] * py + triangle.EdgeC[0]);
+					const V rowEdge1 = L::Set(triangle.EdgeB[1] * py + triangle.EdgeC[1]);
+					const V rowEdge2 = L::Set(triangle.EdgeB[2] * py + triangle.EdgeC[2]);
+					const V rowDepth = L::Set(triangle.DepthY * py + triangle.Depth0);
+
+					float* row = &m_Depth[(size_t)y * Width];
+					for (int x = xBegin; x <= triangle.MaxX; x += L::Width)
+					{
+						V px = L::Add(L::Set((float)x), centers);
+						V inside = L::Min(L::Add(L::Mul(edgeA0, px), rowEdge0),
+							L::Min(L::Add(L::Mul(edgeA1, px), rowEdge1), L::Add(L::Mul(edgeA2, px), rowEdge2)));
+						V depth = L::Add(L::Mul(depthX, px), rowDepth);
+
+						V current = L::LoadUnaligned(row + x);
+						L::StoreUnaligned(row + x, L::Min(current, L::SelectGE(inside, zero, depth, current)));
+					}
+				}
+			}
+		}
+
+		// Farthest depth of every column of the band, then of every tile
+		float columnMax[Width];
+		for (uint32_t x = 0; x < Width; x += L::Width)
+		{
+			V farthest = L::LoadUnaligned(&m_Depth[(size_t)bandBegin * Width + x]);
+			for (uint32_t y = 1; y < TileHeight; y++)
+				farthest = L::Max(farthest, L::LoadUnaligned(&m_Depth[(size_t)(bandBegin + y) * Width + x]));
+			L::StoreUnaligned(columnMax + x, farthest);
+		}
+
+		for (uint32_t tile = 0; tile < TileColumns; tile++)
+		{
+			float farthest = columnMax[tile * TileWidth];
+			for (uint32_t x = 1; x < TileWidth; x++)
+				farthest = std::max(farthest, columnMax[tile * TileWidth + x]);
+			m_TileMaxDepth[band * TileColumns + tile] = farthest;
+		}
+	}
+
+	bool OcclusionBuffer::IsVisible(const Math::AABB& bounds) const
+	{
+		glm::vec2 min = glm::vec2(std::numeric_limits<float>::max());
+		glm::vec2 max = glm::vec2(-std::numeric_limits<float>::max());
+		float nearest = std::numeric_limits<float>::max();
+		for (int i = 0; i < 8; i++)
+		{
+			glm::vec3 corner = { i & 1 ? bounds.Max.x : bounds.Min.x, i & 2 ? bounds.Max.y : bounds.Min.y, i & 4 ? bounds.Max.z : bounds.Min.z };
+			glm::vec4 clip = m_ViewProjection * glm::vec4(corner, 1.0f);
+			if (clip.w <= MinClipW)
+				return true;
+
+			glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			min = glm::min(min, glm::vec2(ndc));
+			max = glm::max(max, glm::vec2(ndc));
+			nearest = std::min(nearest, ndc.z * 0.5f + 0.5f);
+		}
+
+		if (nearest < 0.0f)
+			return true;
+
+		// Every pixel the screen rectangle touches, which covers at least the pixels the box does
+		int minX = std::max((int)std::floor((min.x * 0.5f + 0.5f) * Width), 0);
+		int maxX = std::min((int)std::ceil((max.x * 0.5f + 0.5f) * Width) - 1, (int)Width - 1);
+		int minY = std::max((int)std::floor((min.y * 0.5f + 0.5f) * Height), 0);
+		int maxY = std::min((int)std::ceil((max.y * 0.5f + 0.5f) * Height) - 1, (int)Height - 1);
+		if (minX > maxX || minY > maxY)
+			return true; // Off screen, which is for frustum culling to decide
+
+		for (int tileY = minY / (int)TileHeight; tileY <= maxY / (int)TileHeight; tileY++)
+		{
+			for (int tileX = minX / (int)TileWidth; tileX <= maxX / (int)TileWidth; tileX++)
+			{
+				if (m_TileMaxDepth[tileY * TileColumns + tileX] < nearest)
+					continue;
+
+				int xEnd = std::min(maxX, (tileX + 1) * (int)TileWidth - 1);
+				int yEnd = std::min(maxY, (tileY + 1) * (int)TileHeight - 1);
+				for (int y = std::max(minY, tileY * (int)TileHeight); y <= yEnd; y++)
+					for (int x = std::max(minX, tileX * (int)TileWidth); x <= xEnd; x++)
+						if (m_Depth[(size_t)y * Width + x] >= nearest)
+							return true;
+			}
+		}
+		return false;
+	}
+
+}
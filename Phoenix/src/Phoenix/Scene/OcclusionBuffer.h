@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Phoenix/Math/AABB.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace phx {
+
+	// Low resolution depth buffer rasterized on the CPU from designated occluder meshes, so meshes hidden behind them
+	// can be skipped before they reach Renderer3D. Depth is kept per pixel in [0, 1], smaller is nearer, and every
+	// TileWidth x TileHeight tile also keeps its farthest depth so most of a test is answered a tile at a time.
+	// Occluder triangles are set up in parallel, then each row of tiles is rasterized by its own job, SIMD across
+	// pixels, so no two threads ever write the same pixel. Nothing here touches the GPU
+	class OcclusionBuffer
+	{
+	public:
+		static constexpr uint32_t Width = 320;
+		static constexpr uint32_t Height = 192;
+		static constexpr uint32_t TileWidth = 8;
+		static constexpr uint32_t TileHeight = 4;
+
+		OcclusionBuffer();
+
+		// Clears the depth and the occluders
+		void Begin(const glm::mat4& viewProjection);
+
+		// The geometry must stay alive until Rasterize returns
+		void AddOccluder(const glm::vec3* positions, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, const glm::mat4& transform);
+		void Rasterize();
+
+		// False only when every pixel the box covers has an occluder in front of the box's nearest point. Boxes
+		// crossing the near plane are always visible. Safe to call from several threads after Rasterize
+		bool IsVisible(const Math::AABB& bounds) const;
+
+		uint32_t GetOccluderCount() const { return (uint32_t)m_Occluders.size(); }
+		uint32_t GetTriangleCount() const { return m_TriangleCount; } // Set up by the last Rasterize
+		const float* GetDepth() const { return m_Depth.data(); } // Row major, row 0 at the bottom
+	private:
+		struct Occluder
+		{
+			const glm::vec3* Positions;
+			uint32_t VertexCount;
+			const uint32_t* Indices;
+			uint32_t IndexCount;
+			glm::mat4 Transform;
+		};
+
+		// Edge functions are positive inside, and depth is a plane over the screen
+		struct ScreenTriangle
+		{
+			float EdgeA[3], EdgeB[3], EdgeC[3];
+			float DepthX, DepthY, Depth0;
+			int MinX, MaxX, MinY, MaxY; // Covered pixels, inclusive, clamped to the buffer
+		};
+
+		void SetupOccluder(const Occluder& occluder, std::vector<glm::vec4>& screen, std::vector<ScreenTriangle>& outTriangles) const;
+		void RasterizeBand(uint32_t band);
+	private:
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+		std::vector<Occluder> m_Occluders;
+
+		// Indexed by JobSystem thread
+		std::vector<std::vector<ScreenTriangle>> m_ThreadTriangles;
+		std::vector<std::vector<glm::vec4>> m_ThreadClip;
+		uint32_t m_TriangleCount = 0;
+
+		std::vector<float> m_Depth;
+		std::vector<float> m_TileMaxDepth;
+	};
+
+}
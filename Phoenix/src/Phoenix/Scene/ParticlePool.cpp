@@ -0,0 +1,141 @@
+#include "phxpch.h"
+#include "ParticlePool.h"
+
+#include "Phoenix/Math/SIMDLanes.h"
+#include "Phoenix/Threading/JobSystem.h"
+
+namespace phx {
+
+	static constexpr uint32_t StreamPadding = 8;
+	static constexpr uint32_t UpdateGrainSize = 16384; // Multiple of StreamPadding
+
+	ParticlePool::ParticlePool(uint32_t capacity)
+	{
+		SetCapacity(capacity);
+	}
+
+	void ParticlePool::SetCapacity(uint32_t capacity)
+	{
+		m_Capacity = capacity;
+		m_Count = std::min(m_Count, capacity);
+
+		size_t paddedSize = ((size_t)capacity + StreamPadding - 1) / StreamPadding * StreamPadding;
+		for (auto* stream : { &m_PositionX, &m_PositionY, &m_VelocityX, &m_VelocityY, &m_Rotation, &m_AngularVelocity, &m_Age, &m_AgeRate, &m_RightX, &m_RightY })
+			stream->resize(paddedSize, 0.0f);
+		m_Color.resize(paddedSize, 0);
+	}
+
+	bool ParticlePool::Emit(const glm::vec2& position, const glm::vec2& velocity, float rotation, float angularVelocity, float lifetime)
+	{
+		if (m_Count >= m_Capacity)
+			return false;
+
+		uint32_t i = m_Count++;
+		m_PositionX[i] = position.x;
+		m_PositionY[i] = position.y;
+		m_VelocityX[i] = velocity.x;
+		m_VelocityY[i] = velocity.y;
+		m_Rotation[i] = rotation;
+		m_AngularVelocity[i] = angularVelocity;
+		m_Age[i] = 0.0f;
+		m_AgeRate[i] = lifetime > 0.0f ? 1.0f / lifetime : std::numeric_limits<float>::max();
+		m_RightX[i] = 0.0f;
+		m_RightY[i] = 0.0f;
+		m_Color[i] = 0;
+		return true;
+	}
+
+	template<typename L>
+	void ParticlePool::UpdateRange(uint32_t begin, uint32_t end, float ts, const ParticleUpdateParams& params)
+	{
+		using V = typename L::Type;
+
+		const V dt = L::Set(ts);
+		const V damping = L::Set(std::max(1.0f - params.Drag * ts, 0.0f));
+		const V gravityX = L::Set(params.Gravity.x * ts);
+		const V gravityY = L::Set(params.Gravity.y * ts);
+		const V one = L::Set(1.0f);
+
+		const glm::vec4 colorBegin = glm::clamp(params.ColorBegin, 0.0f, 1.0f);
+		const glm::vec4 colorDelta = glm::clamp(params.ColorEnd, 0.0f, 1.0f) - colorBegin;
+		const V colorBeginR = L::Set(colorBegin.r), colorDeltaR = L::Set(colorDelta.r);
+		const V colorBeginG = L::Set(colorBegin.g), colorDeltaG = L::Set(colorDelta.g);
+		const V colorBeginB = L::Set(colorBegin.b), colorDeltaB = L::Set(colorDelta.b);
+		const V colorBeginA = L::Set(colorBegin.a), colorDeltaA = L::Set(colorDelta.a);
+		const V sizeBegin = L::Set(params.SizeBegin), sizeDelta = L::Set(params.SizeEnd - params.SizeBegin);
+
+		// The padding past the last particle absorbs the partial register at the end
+		for (uint32_t i = begin; i < end; i += L::Width)
+		{
+			V velocityX = L::Add(L::Mul(L::LoadUnaligned(&m_VelocityX[i]), damping), gravityX);
+			V velocityY = L::Add(L::Mul(L::LoadUnaligned(&m_VelocityY[i]), damping), gravityY);
+			L::StoreUnaligned(&m_VelocityX[i], velocityX);
+			L::StoreUnaligned(&m_VelocityY[i], velocityY);
+			L::StoreUnaligned(&m_PositionX[i], L::Add(L::LoadUnaligned(&m_PositionX[i]), L::Mul(velocityX, dt)));
+			L::StoreUnaligned(&m_PositionY[i], L::Add(L::LoadUnaligned(&m_PositionY[i]), L::Mul(velocityY, dt)));
+
+			V rotation = L::Add(L::LoadUnaligned(&m_Rotation[i]), L::Mul(L::LoadUnaligned(&m_AngularVelocity[i]), dt));
+			L::StoreUnaligned(&m_Rotation[i], rotation);
+
+			V age = L::Add(L::LoadUnaligned(&m_Age[i]), L::Mul(L::LoadUnaligned(&m_AgeRate[i]), dt));
+			L::StoreUnaligned(&m_Age[i], age);
+			V t = L::Min(age, one);
+
+			V sinR, cosR;
+			L::SinCos(rotation, sinR, cosR);
+			V size = L::Add(sizeBegin, L::Mul(sizeDelta, t));
+			L::StoreUnaligned(&m_RightX[i], L::Mul(cosR, size));
+			L::StoreUnaligned(&m_RightY[i], L::Mul(sinR, size));
+
+			L::StoreUnorm4x8(&m_Color[i],
+				L::Add(colorBeginR, L::Mul(colorDeltaR, t)),
+				L::Add(colorBeginG, L::Mul(colorDeltaG, t)),
+				L::Add(colorBeginB, L::Mul(colorDeltaB, t)),
+				L::Add(colorBeginA, L::Mul(colorDeltaA, t)));
+		}
+	}
+
+	void ParticlePool::RemoveExpired()
+	{
+		uint32_t i = 0;
+		while (i < m_Count)
+		{
+			if (m_Age[i] < 1.0f)
+			{
+				i++;
+				continue;
+			}
+
+			// Move the last particle into the hole, and test it next
+			uint32_t last = --m_Count;
+			m_PositionX[i] = m_PositionX[last];
+			m_PositionY[i] = m_PositionY[last];
+			m_VelocityX[i] = m_VelocityX[last];
+			m_VelocityY[i] = m_VelocityY[last];
+			m_Rotation[i] = m_Rotation[last];
+			m_AngularVelocity[i] = m_AngularVelocity[last];
+			m_Age[i] = m_Age[last];
+			m_AgeRate[i] = m_AgeRate[last];
+			m_RightX[i] = m_RightX[last];
+			m_RightY[i] = m_RightY[last];
+			m_Color[i] = m_Color[last];
+		}
+	}
+
+	void ParticlePool::Update(float ts, const ParticleUpdateParams& params)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		if (m_Count == 0)
+			return;
+
+		JobSystem::ParallelFor(m_Count, UpdateGrainSize, [&](uint32_t begin, uint32_t end, uint32_t)
+		{
+			uint32_t paddedEnd = (end + StreamPadding - 1) / StreamPadding * StreamPadding;
+			UpdateRange<Math::SIMDLanes>(begin, paddedEnd, ts, params);
+		});
+
+		RemoveExpired();
+	}
+
+}
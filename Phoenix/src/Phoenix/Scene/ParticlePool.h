@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace phx {
+
+	// How every particle of a pool evolves. Color and size are interpolated over each particle's lifetime
+	struct ParticleUpdateParams
+	{
+		glm::vec2 Gravity = { 0.0f, 0.0f };
+		float Drag = 0.0f; // Fraction of velocity lost per second
+		glm::vec4 ColorBegin{ 1.0f, 1.0f, 1.0f, 1.0f };
+		glm::vec4 ColorEnd{ 1.0f, 1.0f, 1.0f, 0.0f };
+		float SizeBegin = 0.1f;
+		float SizeEnd = 0.0f;
+	};
+
+	// 2D particles stored as structure of arrays, so updates run over whole SIMD registers and rendering reads
+	// only the streams it needs. Live particles are packed at the front: a dying particle is replaced by the last
+	// live one, so order is not preserved. Streams are padded to a multiple of 8 so kernels never need a tail loop
+	class ParticlePool
+	{
+	public:
+		ParticlePool(uint32_t capacity = 0);
+
+		// Drops the particles that no longer fit
+		void SetCapacity(uint32_t capacity);
+		void Clear() { m_Count = 0; }
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetCount() const { return m_Count; }
+
+		// Returns false when the pool is full. Color and axes are filled in by the next Update
+		bool Emit(const glm::vec2& position, const glm::vec2& velocity, float rotation, float angularVelocity, float lifetime);
+
+		// Integrates velocity, position and rotation, ages every particle, removes the expired ones, then refreshes
+		// color and quad axes. Large pools are split across the JobSystem
+		void Update(float ts, const ParticleUpdateParams& params);
+
+		// Quad of particle i: Origin = Position, Right = (RightX, RightY), Up = (-RightY, RightX)
+		const float* GetPositionX() const { return m_PositionX.data(); }
+		const float* GetPositionY() const { return m_PositionY.data(); }
+		const float* GetRightX() const { return m_RightX.data(); }
+		const float* GetRightY() const { return m_RightY.data(); }
+		const uint32_t* GetColors() const { return m_Color.data(); } // RGBA8
+	private:
+		template<typename L>
+		void UpdateRange(uint32_t begin, uint32_t end, float ts, const ParticleUpdateParams& params);
+		void RemoveExpired();
+	private:
+		uint32_t m_Capacity = 0;
+		uint32_t m_Count = 0;
+
+		std::vector<float> m_PositionX, m_PositionY;
+		std::vector<float> m_VelocityX, m_VelocityY;
+		std::vector<float> m_Rotation, m_AngularVelocity;
+		std::vector<float> m_Age; // 0 at emission, 1 at the end of the lifetime
+		std::vector<float> m_AgeRate; // 1 / lifetime
+		std::vector<float> m_RightX, m_RightY;
+		std::vector<uint32_t> m_Color;
+	};
+
+}
@@ -1,6 +1,7 @@
 #include "phxpch.h"
 #include "Scene.h"
 #include "glm/glm.hpp"
+#include "glm/gtc/constants.hpp"
 
 #include "Phoenix/Renderer/Renderer2D.h"
 #include "Phoenix/Renderer/Renderer3D.h"
@@ -8,15 +9,23 @@
 
 #include "Phoenix/Scene/Components.h"
 #include "Phoenix/Scene/Entity.h"
+#include "Phoenix/Scene/SpatialHash2D.h"
+#include "Phoenix/Scene/BVH3D.h"
+#include "Phoenix/Scene/OcclusionBuffer.h"
 
 #include "Phoenix/Scripting/ScriptableEntity.h"
 
+#include "Phoenix/Math/QuadTransforms.h"
+#include "Phoenix/Threading/JobSystem.h"
+
 #include "box2d/b2_world.h"
 #include "box2d/b2_body.h"
 #include "box2d/b2_fixture.h"
 #include "box2d/b2_polygon_shape.h"
 #include "box2d/b2_circle_shape.h"
 
+#include <random>
+
 namespace phx {
 	static b2BodyType Rigidbody2DTypeToBox2DBody(Rigidbody2DComponent::BodyType bodyType)
 	{
@@ -31,13 +40,97 @@ namespace phx {
 		return b2_staticBody;
 	}
 
+	// Entities whose renderables changed since the last frame. Physics and the properties panel mark the same
+	// entities every frame, so each one is listed once however often it is marked
+	struct DirtyList
+	{
+		std::vector<entt::entity> Entities; // In marking order, so the static batch fills the same way every time
+		std::unordered_set<entt::entity> Marked;
+
+		void Add(entt::entity entity)
+		{
+			if (Marked.insert(entity).second)
+				Entities.push_back(entity);
+		}
+
+		void Clear()
+		{
+			Entities.clear();
+			Marked.clear();
+		}
+	};
+
+	// Per-scene state of the 2D renderer. Components are edited in place, so changes reach it as a list of dirty
+	// entities fed by component signals, physics and Scene::MarkRenderableDirty. Only those are re-read each frame
+	struct Render2DCache
+	{
+		SpatialHash2D Grid; // Bounds of every entity with a sprite or circle
+		DirtyList DirtyEntities;
+
+		// Sprites flagged static are baked into one Renderer2D::StaticBatch
+		Renderer2D::StaticBatch StaticBatch;
+		std::unordered_map<entt::entity, uint32_t> StaticSlots; // Entity -> batch slot
+		std::vector<entt::entity> SlotEntities; // Entity baked into each batch slot
+
+		// Culling scratch, kept to avoid reallocating every frame
+		std::vector<uint32_t> VisibleIDs;
+		std::vector<entt::entity> VisibleSprites;
+		std::vector<entt::entity> VisibleCircles;
+	};
+
+	// Per-scene state of the 3D renderer. Meshes flagged static live in a BVH, rebuilt only when the world bounds of
+	// one of them change. The others are tested against the frustum one by one
+	struct Render3DCache
+	{
+		BVH3D StaticTree;
+		std::unordered_map<entt::entity, Math::AABB> StaticBounds; // Entity -> world bounds, for every mesh in the tree
+		DirtyList DirtyEntities;
+		bool StaticTreeDirty = false;
+
+		std::vector<uint32_t> VisibleIDs;
+
+		// Meshes inside the frustum, tested against the occluders among them before submission
+		struct Candidate
+		{
+			entt::entity Entity;
+			const Mesh* MeshSource;
+			glm::mat4 Transform;
+			Math::AABB Bounds;
+			bool Occluder;
+		};
+		std::vector<Candidate> Candidates;
+		std::vector<uint8_t> CandidateVisible;
+		OcclusionBuffer Occlusion;
+	};
+
 	Scene::Scene()
+		: m_Render2DCache(CreateScope<Render2DCache>()), m_Render3DCache(CreateScope<Render3DCache>())
 	{
+		m_Registry.on_construct<SpriteRendererComponent>().connect<&Scene::OnRenderable2DChanged>(this);
+		m_Registry.on_update<SpriteRendererComponent>().connect<&Scene::OnRenderable2DChanged>(this);
+		m_Registry.on_destroy<SpriteRendererComponent>().connect<&Scene::OnRenderable2DChanged>(this);
+		m_Registry.on_construct<CircleRendererComponent>().connect<&Scene::OnRenderable2DChanged>(this);
+		m_Registry.on_update<CircleRendererComponent>().connect<&Scene::OnRenderable2DChanged>(this);
+		m_Registry.on_destroy<CircleRendererComponent>().connect<&Scene::OnRenderable2DChanged>(this);
+		m_Registry.on_update<TransformComponent>().connect<&Scene::OnRenderable2DChanged>(this);
+		m_Registry.on_construct<MeshComponent>().connect<&Scene::OnRenderable3DChanged>(this);
+		m_Registry.on_update<MeshComponent>().connect<&Scene::OnRenderable3DChanged>(this);
+		m_Registry.on_destroy<MeshComponent>().connect<&Scene::OnRenderable3DChanged>(this);
+		m_Registry.on_update<TransformComponent>().connect<&Scene::OnRenderable3DChanged>(this);
 	}
 
 	Scene::~Scene()
 	{
-
+		m_Registry.on_construct<SpriteRendererComponent>().disconnect(this);
+		m_Registry.on_update<SpriteRendererComponent>().disconnect(this);
+		m_Registry.on_destroy<SpriteRendererComponent>().disconnect(this);
+		m_Registry.on_construct<CircleRendererComponent>().disconnect(this);
+		m_Registry.on_update<CircleRendererComponent>().disconnect(this);
+		m_Registry.on_destroy<CircleRendererComponent>().disconnect(this);
+		m_Registry.on_update<TransformComponent>().disconnect(this);
+		m_Registry.on_construct<MeshComponent>().disconnect(this);
+		m_Registry.on_update<MeshComponent>().disconnect(this);
+		m_Registry.on_destroy<MeshComponent>().disconnect(this);
 	}
 
 	Entity Scene::CreateEntity(const std::string& name)
@@ -82,6 +175,8 @@ namespace phx {
 		newScene->m_GravityX = other->m_GravityX;
 		newScene->m_GravityY = other->m_GravityY;
 
+		newScene->SetSceneType(other->m_SceneType);
+
 		auto& srcSceneRegistry = other->m_Registry;
 		auto& dstSceneRegistry = newScene->m_Registry;
 		std::unordered_map<UUID, entt::entity> enttMap;
@@ -96,13 +191,13 @@ namespace phx {
 			enttMap[uuid] = (entt::entity)newEntity;
 		}
 
-		newScene->m_SceneType = other->m_SceneType;
-
 		// Copy components (except IDComponent and TagComponent)
 
 		CopyComponent<TransformComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
 		CopyComponent<SpriteRendererComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
 		CopyComponent<CircleRendererComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
+		CopyComponent<TilemapComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
+		CopyComponent<ParticleEmitterComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
 		CopyComponent<CameraComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
 		CopyComponent<NativeScriptComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
 		CopyComponent<Rigidbody2DComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
@@ -215,45 +310,408 @@ namespace phx {
 		
 	}
 
+	// Transforms the sprites through Math::ComputeQuadAxes in blocks of 8
+	template<typename Fn>
+	static void ForEachSpriteBlock(entt::registry& registry, const entt::entity* entities, uint32_t count, Fn&& fn)
+	{
+		constexpr uint32_t BlockSize = 8;
+		glm::vec3 translations[BlockSize], rotations[BlockSize], scales[BlockSize];
+		Math::QuadAxes axes[BlockSize];
+
+		for (uint32_t blockBegin = 0; blockBegin < count; blockBegin += BlockSize)
+		{
+			uint32_t blockCount = std::min(BlockSize, count - blockBegin);
+			for (uint32_t i = 0; i < blockCount; i++)
+			{
+				const auto& transform = registry.get<TransformComponent>(entities[blockBegin + i]);
+				translations[i] = transform.Translation;
+				rotations[i] = transform.Rotation;
+				scales[i] = transform.Scale;
+			}
+
+			Math::ComputeQuadAxes(translations, rotations, scales, blockCount, axes);
+
+			for (uint32_t i = 0; i < blockCount; i++)
+			{
+				entt::entity entity = entities[blockBegin + i];
+				fn(entity, axes[i], registry.get<SpriteRendererComponent>(entity));
+			}
+		}
+	}
+
+	static void RemoveStaticSprite(Render2DCache& cache, entt::entity entity)
+	{
+		auto it = cache.StaticSlots.find(entity);
+		if (it == cache.StaticSlots.end())
+			return;
+
+		// The batch moves its last sprite into the freed slot
+		uint32_t slot = it->second;
+		cache.StaticBatch.Remove(slot);
+		cache.StaticSlots.erase(it);
+
+		entt::entity moved = cache.SlotEntities.back();
+		cache.SlotEntities[slot] = moved;
+		cache.SlotEntities.pop_back();
+
+		if (slot < cache.SlotEntities.size())
+			cache.StaticSlots[moved] = slot;
+	}
+
+	void Scene::SetSceneType(SceneType type)
+	{
+		if (type == m_SceneType)
+			return;
+
+		// Only the cache of the current type hears about changes. The one left behind is emptied and the other
+		// rebuilt from every renderable it covers
+		m_SceneType = type;
+		switch (m_SceneType)
+		{
+		case SceneType::Scene2D:
+		{
+			Render3DCache& old = *m_Render3DCache;
+			old.StaticTree.Clear();
+			old.StaticBounds.clear();
+			old.StaticTreeDirty = false;
+			old.DirtyEntities.Clear();
+
+			for (auto entity : m_Registry.view<SpriteRendererComponent>())
+				m_Render2DCache->DirtyEntities.Add(entity);
+			for (auto entity : m_Registry.view<CircleRendererComponent>())
+				m_Render2DCache->DirtyEntities.Add(entity);
+			break;
+		}
+		case SceneType::Scene3D:
+		{
+			Render2DCache& old = *m_Render2DCache;
+			old.Grid.Clear();
+			old.StaticBatch.Clear();
+			old.StaticSlots.clear();
+			old.SlotEntities.clear();
+			old.DirtyEntities.Clear();
+
+			for (auto entity : m_Registry.view<MeshComponent>())
+				m_Render3DCache->DirtyEntities.Add(entity);
+			break;
+		}
+		}
+	}
+
+	void Scene::MarkRenderableDirty(Entity entity)
+	{
+		switch (m_SceneType)
+		{
+		case SceneType::Scene2D: m_Render2DCache->DirtyEntities.Add((entt::entity)entity); break;
+		case SceneType::Scene3D: m_Render3DCache->DirtyEntities.Add((entt::entity)entity); break;
+		}
+	}
+
+	void Scene::OnRenderable2DChanged(entt::registry& registry, entt::entity entity)
+	{
+		if (m_SceneType == SceneType::Scene2D)
+			m_Render2DCache->DirtyEntities.Add(entity);
+	}
+
+	void Scene::UpdateRenderables2D()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		Render2DCache& cache = *m_Render2DCache;
+		for (entt::entity entity : cache.DirtyEntities.Entities)
+		{
+			uint32_t id = (uint32_t)entity;
+
+			// Destroy signals fire before removal, so the components are checked now rather than then
+			bool valid = m_Registry.valid(entity) && m_Registry.all_of<TransformComponent>(entity);
+			SpriteRendererComponent* sprite = valid ? m_Registry.try_get<SpriteRendererComponent>(entity) : nullptr;
+			bool hasCircle = valid && m_Registry.all_of<CircleRendererComponent>(entity);
+			if (!sprite && !hasCircle)
+			{
+				cache.Grid.Remove(id);
+				RemoveStaticSprite(cache, entity);
+				continue;
+			}
+
+			const auto& transform = m_Registry.get<TransformComponent>(entity);
+			Math::QuadAxes axes;
+			Math::ComputeQuadAxes(&transform.Translation, &transform.Rotation, &transform.Scale, 1, &axes);
+			cache.Grid.Update(id, Math::ComputeQuadBounds(axes));
+
+			if (!sprite || !sprite->Static)
+			{
+				RemoveStaticSprite(cache, entity);
+				continue;
+			}
+
+			// Static sprites whose texture does not fit in the batch are drawn dynamically
+			auto it = cache.StaticSlots.find(entity);
+			if (it != cache.StaticSlots.end())
+			{
+				if (!cache.StaticBatch.Update(it->second, axes, *sprite, (int)entity))
+					RemoveStaticSprite(cache, entity);
+				continue;
+			}
+
+			int32_t slot = cache.StaticBatch.Add(axes, *sprite, (int)entity);
+			if (slot >= 0)
+			{
+				cache.StaticSlots[entity] = (uint32_t)slot;
+				cache.SlotEntities.push_back(entity);
+			}
+		}
+		cache.DirtyEntities.Clear();
+	}
+
 	void Scene::Render2D()
 	{
-		// Draw sprites
+		UpdateRenderables2D();
+
+		Render2DCache& cache = *m_Render2DCache;
+
+		// Tilemaps are backgrounds and draw first, then static sprites. Both only upload what changed
 		{
-			auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-			for (auto entity : group)
+			auto view = m_Registry.view<TransformComponent, TilemapComponent>();
+			for (auto entity : view)
 			{
-				auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
+				auto [transform, tilemap] = view.get<TransformComponent, TilemapComponent>(entity);
+				Renderer2D::DrawTilemap(transform.GetTransform(), tilemap, (int)entity);
+			}
+		}
+		Renderer2D::DrawStaticBatch(cache.StaticBatch);
+
+		// Cull against the camera before any transform work. Sorting by ID keeps the submission
+		// order stable from frame to frame
+		cache.VisibleIDs.clear();
+		cache.Grid.Query(Renderer2D::GetViewBounds(), cache.VisibleIDs);
+		std::sort(cache.VisibleIDs.begin(), cache.VisibleIDs.end());
+
+		cache.VisibleSprites.clear();
+		cache.VisibleCircles.clear();
+		for (uint32_t id : cache.VisibleIDs)
+		{
+			entt::entity entity = (entt::entity)id;
+
+			SpriteRendererComponent* sprite = m_Registry.try_get<SpriteRendererComponent>(entity);
+			if (sprite && !(sprite->Static && cache.StaticSlots.find(entity) != cache.StaticSlots.end()))
+				cache.VisibleSprites.push_back(entity);
+
+			if (m_Registry.all_of<CircleRendererComponent>(entity))
+				cache.VisibleCircles.push_back(entity);
+		}
 
-				Renderer2D::DrawSprite(transform.GetTransform(), sprite, (int)entity);
+		// Draw sprites
+		{
+			uint32_t spriteCount = (uint32_t)cache.VisibleSprites.size();
+			const entt::entity* sprites = cache.VisibleSprites.data();
+			if (Renderer2D::GetSubmissionMode() == Renderer2D::SubmissionMode::Sorted)
+			{
+				// Record one contiguous slice of the visible sprites per draw list, in parallel
+				uint32_t sliceSize = std::max((spriteCount + Renderer2D::GetDrawListCount() - 1) / Renderer2D::GetDrawListCount(), 1024u);
+				JobSystem::ParallelFor(spriteCount, sliceSize, [&](uint32_t begin, uint32_t end, uint32_t)
+				{
+					Renderer2D::DrawList& drawList = Renderer2D::GetDrawList(begin / sliceSize);
+					ForEachSpriteBlock(m_Registry, sprites + begin, end - begin, [&](entt::entity entity, const Math::QuadAxes& axes, SpriteRendererComponent& sprite)
+					{
+						drawList.DrawSprite(axes, sprite, (int)entity);
+					});
+				});
+			}
+			else
+			{
+				ForEachSpriteBlock(m_Registry, sprites, spriteCount, [&](entt::entity entity, const Math::QuadAxes& axes, SpriteRendererComponent& sprite)
+				{
+					Renderer2D::DrawSprite(axes, sprite, (int)entity);
+				});
 			}
 		}
 
 		// Draw circles
 		{
-			auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
+			for (auto entity : cache.VisibleCircles)
+			{
+				auto [transform, circle] = m_Registry.get<TransformComponent, CircleRendererComponent>(entity);
+
+				Renderer2D::DrawCircle(transform.GetTransform(), circle.Color, circle.Thickness, circle.Fade, (int)entity, circle.SortingLayer);
+			}
+		}
+
+		// Draw particles, sorted with the sprites and circles of their layer
+		{
+			auto view = m_Registry.view<TransformComponent, ParticleEmitterComponent>();
 			for (auto entity : view)
 			{
-				auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
+				auto [transform, emitter] = view.get<TransformComponent, ParticleEmitterComponent>(entity);
+				Renderer2D::DrawParticles(emitter.Pool, emitter.Texture, transform.Translation, (int)entity, emitter.SortingLayer);
+			}
+		}
+	}
+
+	void Scene::UpdateParticles(DeltaTime dt)
+	{
+		PHX_PROFILE_FUNCTION();
 
-				Renderer2D::DrawCircle(transform.GetTransform(), circle.Color, circle.Thickness, circle.Fade, (int)entity);
+		static std::mt19937 s_Engine(std::random_device{}());
+		std::uniform_real_distribution<float> variation(-0.5f, 0.5f);
+
+		float ts = dt;
+		auto view = m_Registry.view<TransformComponent, ParticleEmitterComponent>();
+		for (auto entity : view)
+		{
+			auto [transform, emitter] = view.get<TransformComponent, ParticleEmitterComponent>(entity);
+
+			if (emitter.Pool.GetCapacity() != emitter.MaxParticles)
+				emitter.Pool.SetCapacity(emitter.MaxParticles);
+
+			if (emitter.Emitting)
+			{
+				emitter.EmissionAccumulator += emitter.EmissionRate * ts;
+				uint32_t emitCount = (uint32_t)emitter.EmissionAccumulator;
+				emitter.EmissionAccumulator -= (float)emitCount;
+
+				glm::vec2 position = transform.Translation;
+				for (uint32_t i = 0; i < emitCount; i++)
+				{
+					glm::vec2 velocity = emitter.Velocity + emitter.VelocityVariation * glm::vec2(variation(s_Engine), variation(s_Engine));
+					float angularVelocity = emitter.AngularVelocity + emitter.AngularVelocityVariation * variation(s_Engine);
+					float lifetime = emitter.Lifetime + emitter.LifetimeVariation * variation(s_Engine);
+					float rotation = (variation(s_Engine) + 0.5f) * glm::two_pi<float>();
+					if (!emitter.Pool.Emit(position, velocity, rotation, angularVelocity, lifetime))
+						break;
+				}
 			}
+
+			emitter.Pool.Update(ts, emitter.Update);
+		}
+	}
+
+	void Scene::OnRenderable3DChanged(entt::registry& registry, entt::entity entity)
+	{
+		if (m_SceneType == SceneType::Scene3D)
+			m_Render3DCache->DirtyEntities.Add(entity);
+	}
+
+	void Scene::UpdateRenderables3D()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		Render3DCache& cache = *m_Render3DCache;
+		for (entt::entity entity : cache.DirtyEntities.Entities)
+		{
+			// Destroy signals fire before removal, so the components are checked now rather than then
+			bool valid = m_Registry.valid(entity) && m_Registry.all_of<TransformComponent>(entity);
+			MeshComponent* mesh = valid ? m_Registry.try_get<MeshComponent>(entity) : nullptr;
+			if (!mesh || !mesh->Static || !mesh->Mesh)
+			{
+				if (cache.StaticBounds.erase(entity))
+					cache.StaticTreeDirty = true;
+				continue;
+			}
+
+			// The properties panel marks the selection dirty every frame, so unchanged bounds must not rebuild
+			Math::AABB bounds = mesh->Mesh->GetBounds().Transform(m_Registry.get<TransformComponent>(entity).GetTransform());
+			auto it = cache.StaticBounds.find(entity);
+			if (it == cache.StaticBounds.end() || it->second.Min != bounds.Min || it->second.Max != bounds.Max)
+			{
+				cache.StaticBounds[entity] = bounds;
+				cache.StaticTreeDirty = true;
+			}
+		}
+		cache.DirtyEntities.Clear();
+
+		if (cache.StaticTreeDirty)
+		{
+			std::vector<BVH3D::Item> items;
+			items.reserve(cache.StaticBounds.size());
+			for (const auto& [entity, bounds] : cache.StaticBounds)
+				items.push_back({ (uint32_t)entity, bounds });
+
+			cache.StaticTree.Build(std::move(items));
+			cache.StaticTreeDirty = false;
 		}
 	}
 
 	void Scene::Render3D()
 	{
+		UpdateRenderables3D();
+
+		Render3DCache& cache = *m_Render3DCache;
+		const Math::Frustum& frustum = Renderer3D::GetFrustum();
+
+		// Static meshes come out of the BVH already culled. Sorting by ID keeps the submission order stable
+		cache.VisibleIDs.clear();
+		cache.StaticTree.Query(frustum, cache.VisibleIDs);
+		std::sort(cache.VisibleIDs.begin(), cache.VisibleIDs.end());
+
+		auto& candidates = cache.Candidates;
+		candidates.clear();
+
+		uint32_t culled = cache.StaticTree.GetCount() - (uint32_t)cache.VisibleIDs.size();
+		for (uint32_t id : cache.VisibleIDs)
+		{
+			entt::entity entity = (entt::entity)id;
+			auto [transform, mesh] = m_Registry.get<TransformComponent, MeshComponent>(entity);
+			if (mesh.Mesh)
+				candidates.push_back({ entity, mesh.Mesh.get(), transform.GetTransform(), cache.StaticBounds.at(entity), mesh.Occluder });
+		}
+
 		{
 			auto view = m_Registry.view<TransformComponent, MeshComponent>();
 			for (auto entity : view)
 			{
 				auto [transform, mesh] = view.get<TransformComponent, MeshComponent>(entity);
-				glm::mat4 transformMat = glm::translate(glm::mat4(1.0f), transform.Translation);
-				transformMat *= glm::scale(glm::mat4(1.0f), transform.Scale);
-				transformMat *= glm::toMat4(glm::quat(transform.Rotation));
+				if (!mesh.Mesh || cache.StaticBounds.find(entity) != cache.StaticBounds.end())
+					continue;
+
+				glm::mat4 worldTransform = transform.GetTransform();
+				Math::AABB bounds = mesh.Mesh->GetBounds().Transform(worldTransform);
+				if (!frustum.Intersects(bounds))
+				{
+					culled++;
+					continue;
+				}
+
+				candidates.push_back({ entity, mesh.Mesh.get(), worldTransform, bounds, mesh.Occluder });
+			}
+		}
+
+		// Occluders are always drawn, everything else only when some of it is left uncovered by them
+		OcclusionBuffer& occlusion = cache.Occlusion;
+		occlusion.Begin(Renderer3D::GetViewProjection());
+		for (const auto& candidate : candidates)
+		{
+			if (!candidate.Occluder)
+				continue;
+
+			const Mesh::OccluderGeometry& geometry = candidate.MeshSource->GetOccluderGeometry();
+			occlusion.AddOccluder(geometry.Positions.data(), (uint32_t)geometry.Positions.size(), geometry.Indices.data(), (uint32_t)geometry.Indices.size(), candidate.Transform);
+		}
 
-				Renderer3D::SubmitMesh(mesh.Mesh, transformMat, (int)entity);
+		cache.CandidateVisible.assign(candidates.size(), 1);
+		if (occlusion.GetOccluderCount() > 0)
+		{
+			occlusion.Rasterize();
+			JobSystem::ParallelFor((uint32_t)candidates.size(), 256, [&](uint32_t begin, uint32_t end, uint32_t)
+			{
+				for (uint32_t i = begin; i < end; i++)
+					cache.CandidateVisible[i] = candidates[i].Occluder || occlusion.IsVisible(candidates[i].Bounds);
+			});
+		}
+
+		uint32_t occluded = 0;
+		for (size_t i = 0; i < candidates.size(); i++)
+		{
+			if (!cache.CandidateVisible[i])
+			{
+				occluded++;
+				continue;
 			}
+
+			Renderer3D::SubmitMesh(*candidates[i].MeshSource, candidates[i].Transform, (int)candidates[i].Entity);
 		}
+
+		Renderer3D::AddCulledMeshes(culled);
+		Renderer3D::AddOccludedMeshes(occluded);
 	}
 
 	void Scene::UpdateScripts()
@@ -311,9 +769,14 @@ namespace phx {
 					transform.Translation.x = position.x;
 					transform.Translation.y = position.y;
 					transform.Rotation.z = body->GetAngle();
+
+					if (body->IsAwake())
+						MarkRenderableDirty(entity);
 				}
 			}
 
+			UpdateParticles(dt);
+
 			Camera* mainCamera = nullptr;
 			glm::mat4 cameraTransform;
 
@@ -430,8 +893,13 @@ namespace phx {
 				transform.Translation.x = position.x;
 				transform.Translation.y = position.y;
 				transform.Rotation.z = body->GetAngle();
+
+				if (body->IsAwake())
+					MarkRenderableDirty(entity);
 			}
 
+			UpdateParticles(dt);
+
 			Renderer2D::BeginScene(camera);
 			Render2D();
 			Renderer2D::EndScene();
@@ -473,6 +941,8 @@ namespace phx {
 		CopyComponentIfExists<TransformComponent>(newEntity, entity);
 		CopyComponentIfExists<SpriteRendererComponent>(newEntity, entity);
 		CopyComponentIfExists<CircleRendererComponent>(newEntity, entity);
+		CopyComponentIfExists<TilemapComponent>(newEntity, entity);
+		CopyComponentIfExists<ParticleEmitterComponent>(newEntity, entity);
 		CopyComponentIfExists<CameraComponent>(newEntity, entity);
 		CopyComponentIfExists<NativeScriptComponent>(newEntity, entity);
 		CopyComponentIfExists<Rigidbody2DComponent>(newEntity, entity);
@@ -532,6 +1002,18 @@ namespace phx {
 
 	}
 
+	template<>
+	void Scene::OnComponentAdded<TilemapComponent>(Entity entity, TilemapComponent& component)
+	{
+
+	}
+
+	template<>
+	void Scene::OnComponentAdded<ParticleEmitterComponent>(Entity entity, ParticleEmitterComponent& component)
+	{
+
+	}
+
 	template<>
 	void Scene::OnComponentAdded<TagComponent>(Entity entity, TagComponent& component)
 	{
@@ -12,6 +12,8 @@ class b2World;
 
 namespace phx {
 	class Entity;
+	struct Render2DCache;
+	struct Render3DCache;
 
 	class Scene
 	{
@@ -30,7 +32,7 @@ namespace phx {
 		void DestroyEntity(Entity entity);
 
 		SceneType GetSceneType() { return m_SceneType; }
-		void SetSceneType(SceneType type) { m_SceneType = type; }
+		void SetSceneType(SceneType type);
 
 		void SetGravity(float x, float y);
 
@@ -40,6 +42,10 @@ namespace phx {
 		void Render2D();
 		void Render3D();
 
+		// Call after editing an entity's transform or renderer components in place, so culling, static
+		// batches and the static mesh BVH pick up the change. Physics and component add/remove already do this
+		void MarkRenderableDirty(Entity entity);
+
 		void UpdateScripts();
 
 		void OnUpdateRuntime(DeltaTime dt);
@@ -50,6 +56,8 @@ namespace phx {
 		void DuplicateEntity(Entity entity);
 
 		uint32_t GetRegistrySize() { return m_Registry.size(); }
+		// False for null and for destroyed entities, even once their ID is reused
+		bool IsValid(entt::entity handle) const { return m_Registry.valid(handle); }
 
 		Entity GetPrimaryCameraEntity();
 
@@ -59,6 +67,12 @@ namespace phx {
 		template<typename T>
 		void OnComponentAdded(Entity entity, T& component);
 
+		void OnRenderable2DChanged(entt::registry& registry, entt::entity entity);
+		void UpdateRenderables2D();
+		void OnRenderable3DChanged(entt::registry& registry, entt::entity entity);
+		void UpdateRenderables3D();
+		void UpdateParticles(DeltaTime dt);
+
 		entt::registry m_Registry;
 		uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
 		
@@ -71,6 +85,9 @@ namespace phx {
 
 		SkyBox m_Skybox = SkyBox("assets/skybox/Skybox_Back.bmp");
 
+		Scope<Render2DCache> m_Render2DCache;
+		Scope<Render3DCache> m_Render3DCache;
+
 		friend class Entity;
 		friend class SceneSerializer;
 		friend class SceneHierarchyPanel;
@@ -153,6 +153,50 @@ namespace phx {
 	}
 
 
+	// Tiles are stored row by row from the bottom as run-length pairs: [count, tile, count, tile, ...]
+	static void SerializeTiles(YAML::Emitter& out, const TilemapComponent& tilemap)
+	{
+		out << YAML::Flow << YAML::BeginSeq;
+
+		uint32_t runLength = 0;
+		uint16_t runTile = 0;
+		for (uint32_t y = 0; y < tilemap.GetHeight(); y++)
+		{
+			for (uint32_t x = 0; x < tilemap.GetWidth(); x++)
+			{
+				uint16_t tile = tilemap.GetTile(x, y);
+				if (runLength > 0 && tile != runTile)
+				{
+					out << runLength << runTile;
+					runLength = 0;
+				}
+				runTile = tile;
+				runLength++;
+			}
+		}
+		if (runLength > 0)
+			out << runLength << runTile;
+
+		out << YAML::EndSeq;
+	}
+
+	static void DeserializeTiles(const YAML::Node& tiles, TilemapComponent& tilemap)
+	{
+		uint32_t width = tilemap.GetWidth();
+		uint64_t tileCount = (uint64_t)width * tilemap.GetHeight();
+		uint64_t index = 0;
+		for (size_t i = 0; i + 1 < tiles.size() && index < tileCount; i += 2)
+		{
+			uint32_t runLength = tiles[i].as<uint32_t>();
+			uint16_t tile = tiles[i + 1].as<uint16_t>();
+			for (uint64_t end = std::min(index + runLength, tileCount); index < end; index++)
+			{
+				if (tile != 0)
+					tilemap.SetTile((uint32_t)(index % width), (uint32_t)(index / width), tile);
+			}
+		}
+	}
+
 	SceneSerializer::SceneSerializer(const Ref<Scene>& scene)
 		: m_Scene(scene)
 	{
@@ -234,6 +278,8 @@ namespace phx {
 				out << YAML::Key << "Textured" << YAML::Value << false;
 			}
 			out << YAML::Key << "TextureTiling" << YAML::Value << spriteRendererComponent.TilingFactor;
+			out << YAML::Key << "SortingLayer" << YAML::Value << spriteRendererComponent.SortingLayer;
+			out << YAML::Key << "Static" << YAML::Value << spriteRendererComponent.Static;
 
 			out << YAML::EndMap; // SpriteRendererComponent
 		}
@@ -247,10 +293,57 @@ namespace phx {
 			out << YAML::Key << "Color" << YAML::Value << circleRendererComponent.Color;
 			out << YAML::Key << "Thickness" << YAML::Value << circleRendererComponent.Thickness;
 			out << YAML::Key << "Fade" << YAML::Value << circleRendererComponent.Fade;
+			out << YAML::Key << "SortingLayer" << YAML::Value << circleRendererComponent.SortingLayer;
 
 			out << YAML::EndMap; // CircleRendererComponent
 		}
 
+		if (entity.HasComponent<TilemapComponent>())
+		{
+			out << YAML::Key << "TilemapComponent";
+			out << YAML::BeginMap; // TilemapComponent
+
+			auto& tilemapComponent = entity.GetComponent<TilemapComponent>();
+			out << YAML::Key << "AtlasPath" << YAML::Value << tilemapComponent.Path;
+			out << YAML::Key << "AtlasColumns" << YAML::Value << tilemapComponent.AtlasColumns;
+			out << YAML::Key << "AtlasRows" << YAML::Value << tilemapComponent.AtlasRows;
+			out << YAML::Key << "TileSize" << YAML::Value << tilemapComponent.TileSize;
+			out << YAML::Key << "Color" << YAML::Value << tilemapComponent.Color;
+			out << YAML::Key << "Width" << YAML::Value << tilemapComponent.GetWidth();
+			out << YAML::Key << "Height" << YAML::Value << tilemapComponent.GetHeight();
+			out << YAML::Key << "Tiles" << YAML::Value;
+			SerializeTiles(out, tilemapComponent);
+
+			out << YAML::EndMap; // TilemapComponent
+		}
+
+		if (entity.HasComponent<ParticleEmitterComponent>())
+		{
+			out << YAML::Key << "ParticleEmitterComponent";
+			out << YAML::BeginMap; // ParticleEmitterComponent
+
+			auto& emitter = entity.GetComponent<ParticleEmitterComponent>();
+			out << YAML::Key << "EmissionRate" << YAML::Value << emitter.EmissionRate;
+			out << YAML::Key << "MaxParticles" << YAML::Value << emitter.MaxParticles;
+			out << YAML::Key << "Emitting" << YAML::Value << emitter.Emitting;
+			out << YAML::Key << "Lifetime" << YAML::Value << emitter.Lifetime;
+			out << YAML::Key << "LifetimeVariation" << YAML::Value << emitter.LifetimeVariation;
+			out << YAML::Key << "Velocity" << YAML::Value << emitter.Velocity;
+			out << YAML::Key << "VelocityVariation" << YAML::Value << emitter.VelocityVariation;
+			out << YAML::Key << "AngularVelocity" << YAML::Value << emitter.AngularVelocity;
+			out << YAML::Key << "AngularVelocityVariation" << YAML::Value << emitter.AngularVelocityVariation;
+			out << YAML::Key << "Gravity" << YAML::Value << emitter.Update.Gravity;
+			out << YAML::Key << "Drag" << YAML::Value << emitter.Update.Drag;
+			out << YAML::Key << "ColorBegin" << YAML::Value << emitter.Update.ColorBegin;
+			out << YAML::Key << "ColorEnd" << YAML::Value << emitter.Update.ColorEnd;
+			out << YAML::Key << "SizeBegin" << YAML::Value << emitter.Update.SizeBegin;
+			out << YAML::Key << "SizeEnd" << YAML::Value << emitter.Update.SizeEnd;
+			out << YAML::Key << "TexturePath" << YAML::Value << emitter.Path;
+			out << YAML::Key << "SortingLayer" << YAML::Value << emitter.SortingLayer;
+
+			out << YAML::EndMap; // ParticleEmitterComponent
+		}
+
 		if (entity.HasComponent<Rigidbody2DComponent>())
 		{
 			out << YAML::Key << "Rigidbody2DComponent";
@@ -406,6 +499,10 @@ namespace phx {
 						src.Path = spriteRendererComponent["TexturePath"].as<std::string>();
 					}					
 					src.TilingFactor = spriteRendererComponent["TextureTiling"].as<float>();
+					if (spriteRendererComponent["SortingLayer"])
+						src.SortingLayer = spriteRendererComponent["SortingLayer"].as<int>();
+					if (spriteRendererComponent["Static"])
+						src.Static = spriteRendererComponent["Static"].as<bool>();
 				}
 
 				auto circleRendererComponent = entity["CircleRendererComponent"];
@@ -415,6 +512,49 @@ namespace phx {
 					crc.Color = circleRendererComponent["Color"].as<glm::vec4>();
 					crc.Thickness = circleRendererComponent["Thickness"].as<float>();
 					crc.Fade = circleRendererComponent["Fade"].as<float>();
+					if (circleRendererComponent["SortingLayer"])
+						crc.SortingLayer = circleRendererComponent["SortingLayer"].as<int>();
+				}
+
+				auto tilemapComponent = entity["TilemapComponent"];
+				if (tilemapComponent)
+				{
+					auto& tc = deserializedEntity.AddComponent<TilemapComponent>();
+					tc.Path = tilemapComponent["AtlasPath"].as<std::string>();
+					if (!tc.Path.empty())
+						tc.Atlas = Texture2D::Create(tc.Path);
+					tc.AtlasColumns = tilemapComponent["AtlasColumns"].as<int>();
+					tc.AtlasRows = tilemapComponent["AtlasRows"].as<int>();
+					tc.TileSize = tilemapComponent["TileSize"].as<glm::vec2>();
+					tc.Color = tilemapComponent["Color"].as<glm::vec4>();
+					tc.Resize(tilemapComponent["Width"].as<uint32_t>(), tilemapComponent["Height"].as<uint32_t>());
+					DeserializeTiles(tilemapComponent["Tiles"], tc);
+				}
+
+				auto particleEmitterComponent = entity["ParticleEmitterComponent"];
+				if (particleEmitterComponent)
+				{
+					auto& pec = deserializedEntity.AddComponent<ParticleEmitterComponent>();
+					pec.EmissionRate = particleEmitterComponent["EmissionRate"].as<float>();
+					pec.MaxParticles = particleEmitterComponent["MaxParticles"].as<uint32_t>();
+					pec.Emitting = particleEmitterComponent["Emitting"].as<bool>();
+					pec.Lifetime = particleEmitterComponent["Lifetime"].as<float>();
+					pec.LifetimeVariation = particleEmitterComponent["LifetimeVariation"].as<float>();
+					pec.Velocity = particleEmitterComponent["Velocity"].as<glm::vec2>();
+					pec.VelocityVariation = particleEmitterComponent["VelocityVariation"].as<glm::vec2>();
+					pec.AngularVelocity = particleEmitterComponent["AngularVelocity"].as<float>();
+					pec.AngularVelocityVariation = particleEmitterComponent["AngularVelocityVariation"].as<float>();
+					pec.Update.Gravity = particleEmitterComponent["Gravity"].as<glm::vec2>();
+					pec.Update.Drag = particleEmitterComponent["Drag"].as<float>();
+					pec.Update.ColorBegin = particleEmitterComponent["ColorBegin"].as<glm::vec4>();
+					pec.Update.ColorEnd = particleEmitterComponent["ColorEnd"].as<glm::vec4>();
+					pec.Update.SizeBegin = particleEmitterComponent["SizeBegin"].as<float>();
+					pec.Update.SizeEnd = particleEmitterComponent["SizeEnd"].as<float>();
+					pec.Path = particleEmitterComponent["TexturePath"].as<std::string>();
+					if (!pec.Path.empty())
+						pec.Texture = Texture2D::Create(pec.Path);
+					if (particleEmitterComponent["SortingLayer"])
+						pec.SortingLayer = particleEmitterComponent["SortingLayer"].as<int>();
 				}
 
 				auto rigidbody2DComponent = entity["Rigidbody2DComponent"];
@@ -0,0 +1,148 @@
+#include "phxpch.h"
+#include "SpatialHash2D.h"
+
+#include <cmath>
+
+namespace phx {
+
+	static uint64_t PackCell(int32_t x, int32_t y)
+	{
+		return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	}
+
+	SpatialHash2D::SpatialHash2D(float cellSize)
+		: m_CellSize(cellSize)
+	{
+		PHX_CORE_ASSERT(cellSize > 0.0f, "Cell size must be positive!");
+	}
+
+	uint64_t SpatialHash2D::GetCellKey(const Math::AABB2D& bounds) const
+	{
+		glm::vec2 halfExtent = bounds.GetHalfExtent();
+		if (halfExtent.x > m_CellSize * 0.5f || halfExtent.y > m_CellSize * 0.5f)
+			return OversizedCell;
+
+		glm::vec2 center = bounds.GetCenter();
+		return PackCell((int32_t)std::floor(center.x / m_CellSize), (int32_t)std::floor(center.y / m_CellSize));
+	}
+
+	std::vector<uint32_t>& SpatialHash2D::GetCellItems(uint64_t cell)
+	{
+		return cell == OversizedCell ? m_Oversized : m_Cells[cell];
+	}
+
+	void SpatialHash2D::Unlink(uint32_t itemIndex)
+	{
+		Item& item = m_Items[itemIndex];
+		std::vector<uint32_t>& cellItems = GetCellItems(item.Cell);
+
+		uint32_t movedIndex = cellItems.back();
+		cellItems[item.CellIndex] = movedIndex;
+		m_Items[movedIndex].CellIndex = item.CellIndex;
+		cellItems.pop_back();
+
+		if (cellItems.empty() && item.Cell != OversizedCell)
+			m_Cells.erase(item.Cell);
+	}
+
+	void SpatialHash2D::Update(uint32_t id, const Math::AABB2D& bounds)
+	{
+		uint64_t cell = GetCellKey(bounds);
+
+		auto it = m_ItemLookup.find(id);
+		if (it != m_ItemLookup.end())
+		{
+			Item& item = m_Items[it->second];
+			item.Bounds = bounds;
+			if (item.Cell == cell)
+				return;
+
+			Unlink(it->second);
+
+			std::vector<uint32_t>& cellItems = GetCellItems(cell);
+			item.Cell = cell;
+			item.CellIndex = (uint32_t)cellItems.size();
+			cellItems.push_back(it->second);
+			return;
+		}
+
+		uint32_t itemIndex = (uint32_t)m_Items.size();
+		std::vector<uint32_t>& cellItems = GetCellItems(cell);
+		m_Items.push_back({ id, bounds, cell, (uint32_t)cellItems.size() });
+		cellItems.push_back(itemIndex);
+		m_ItemLookup[id] = itemIndex;
+	}
+
+	void SpatialHash2D::Remove(uint32_t id)
+	{
+		auto it = m_ItemLookup.find(id);
+		if (it == m_ItemLookup.end())
+			return;
+
+		uint32_t itemIndex = it->second;
+		Unlink(itemIndex);
+		m_ItemLookup.erase(it);
+
+		// Move the last item into the hole
+		uint32_t lastIndex = (uint32_t)m_Items.size() - 1;
+		if (itemIndex != lastIndex)
+		{
+			Item& moved = m_Items[itemIndex] = m_Items[lastIndex];
+			GetCellItems(moved.Cell)[moved.CellIndex] = itemIndex;
+			m_ItemLookup[moved.ID] = itemIndex;
+		}
+		m_Items.pop_back();
+	}
+
+	void SpatialHash2D::Clear()
+	{
+		m_Items.clear();
+		m_ItemLookup.clear();
+		m_Cells.clear();
+		m_Oversized.clear();
+	}
+
+	void SpatialHash2D::Query(const Math::AABB2D& bounds, std::vector<uint32_t>& outIDs) const
+	{
+		auto testItems = [&](const std::vector<uint32_t>& cellItems)
+		{
+			for (uint32_t itemIndex : cellItems)
+			{
+				const Item& item = m_Items[itemIndex];
+				if (item.Bounds.Intersects(bounds))
+					outIDs.push_back(item.ID);
+			}
+		};
+
+		testItems(m_Oversized);
+
+		// Items reach at most half a cell past the cell holding their center
+		float looseness = m_CellSize * 0.5f;
+		double minX = std::floor((bounds.Min.x - looseness) / m_CellSize);
+		double minY = std::floor((bounds.Min.y - looseness) / m_CellSize);
+		double maxX = std::floor((bounds.Max.x + looseness) / m_CellSize);
+		double maxY = std::floor((bounds.Max.y + looseness) / m_CellSize);
+
+		// Walking the occupied cells is cheaper once the query covers more cells than exist, and also
+		// handles queries past the range of cell coordinates
+		double cellsCovered = (maxX - minX + 1.0) * (maxY - minY + 1.0);
+		bool inRange = minX >= INT32_MIN && minY >= INT32_MIN && maxX <= INT32_MAX && maxY <= INT32_MAX;
+		if (!inRange || !(cellsCovered <= (double)m_Cells.size()))
+		{
+			for (const auto& [cell, cellItems] : m_Cells)
+				testItems(cellItems);
+			return;
+		}
+
+		for (int64_t y = (int64_t)minY; y <= (int64_t)maxY; y++)
+		{
+			for (int64_t x = (int64_t)minX; x <= (int64_t)maxX; x++)
+			{
+				auto it = m_Cells.find(PackCell((int32_t)x, (int32_t)y));
+				if (it != m_Cells.end())
+					testItems(it->second);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Phoenix/Math/AABB2D.h"
+
+#include <vector>
+#include <unordered_map>
+
+namespace phx {
+
+	// Loose grid of 2D bounds keyed by ID. Items are filed under the cell holding their center, so an item never
+	// reaches further than half a cell past it and queries only need to widen by that much. Items larger than a
+	// cell go to a separate list that every query tests.
+	class SpatialHash2D
+	{
+	public:
+		SpatialHash2D(float cellSize = 16.0f);
+
+		// Inserts the item, or moves it if the ID is already present
+		void Update(uint32_t id, const Math::AABB2D& bounds);
+		void Remove(uint32_t id);
+		void Clear();
+
+		bool Contains(uint32_t id) const { return m_ItemLookup.find(id) != m_ItemLookup.end(); }
+		uint32_t GetCount() const { return (uint32_t)m_Items.size(); }
+
+		// Appends the IDs of every item overlapping the bounds, in no particular order
+		void Query(const Math::AABB2D& bounds, std::vector<uint32_t>& outIDs) const;
+	private:
+		static constexpr uint64_t OversizedCell = ~0ull;
+
+		struct Item
+		{
+			uint32_t ID;
+			Math::AABB2D Bounds;
+			uint64_t Cell;
+			uint32_t CellIndex; // Position in the cell's item list
+		};
+
+		uint64_t GetCellKey(const Math::AABB2D& bounds) const;
+		std::vector<uint32_t>& GetCellItems(uint64_t cell);
+		void Unlink(uint32_t itemIndex);
+	private:
+		float m_CellSize;
+
+		std::vector<Item> m_Items;
+		std::unordered_map<uint32_t, uint32_t> m_ItemLookup; // ID -> index in m_Items
+		std::unordered_map<uint64_t, std::vector<uint32_t>> m_Cells; // Cell -> indices in m_Items
+		std::vector<uint32_t> m_Oversized;
+	};
+
+}
@@ -0,0 +1,155 @@
+#include "phxpch.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace phx {
+	struct JobSystemData
+	{
+		std::vector<std::thread> Workers;
+
+		std::mutex Mutex;
+		std::condition_variable WakeCondition;
+		std::condition_variable DoneCondition;
+		bool Running = false;
+		uint64_t Generation = 0;
+		uint32_t PendingWorkers = 0;
+
+		// Loop currently being run
+		std::mutex LoopMutex;
+		const JobSystem::RangeFn* Function = nullptr;
+		uint32_t Count = 0;
+		uint32_t GrainSize = 1;
+		uint32_t RangeCount = 0;
+		std::atomic<uint32_t> NextRange = 0;
+	};
+
+	static JobSystemData s_Data;
+
+	static thread_local uint32_t t_ThreadIndex = 0;
+	static thread_local bool t_InsideLoop = false;
+
+	static void RunRanges(uint32_t threadIndex)
+	{
+		while (true)
+		{
+			uint32_t range = s_Data.NextRange.fetch_add(1, std::memory_order_relaxed);
+			if (range >= s_Data.RangeCount)
+				break;
+
+			uint32_t begin = range * s_Data.GrainSize;
+			uint32_t end = std::min(begin + s_Data.GrainSize, s_Data.Count);
+			(*s_Data.Function)(begin, end, threadIndex);
+		}
+	}
+
+	static void WorkerLoop(uint32_t threadIndex)
+	{
+		t_ThreadIndex = threadIndex;
+		t_InsideLoop = true;
+
+		uint64_t seenGeneration = 0;
+		while (true)
+		{
+			{
+				std::unique_lock lock(s_Data.Mutex);
+				s_Data.WakeCondition.wait(lock, [&] { return !s_Data.Running || s_Data.Generation != seenGeneration; });
+				if (!s_Data.Running)
+					return;
+				seenGeneration = s_Data.Generation;
+			}
+
+			RunRanges(threadIndex);
+
+			{
+				std::lock_guard lock(s_Data.Mutex);
+				if (--s_Data.PendingWorkers == 0)
+					s_Data.DoneCondition.notify_one();
+			}
+		}
+	}
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		PHX_CORE_ASSERT(!s_Data.Running, "JobSystem already initialized!");
+
+		if (workerCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		s_Data.Running = true;
+		s_Data.Workers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; i++)
+			s_Data.Workers.emplace_back(WorkerLoop, i + 1);
+
+		PHX_CORE_INFO("JobSystem started with {0} worker threads", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		{
+			std::lock_guard lock(s_Data.Mutex);
+			s_Data.Running = false;
+		}
+		s_Data.WakeCondition.notify_all();
+
+		for (std::thread& worker : s_Data.Workers)
+			worker.join();
+		s_Data.Workers.clear();
+	}
+
+	uint32_t JobSystem::GetThreadCount()
+	{
+		return (uint32_t)s_Data.Workers.size() + 1;
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const RangeFn& fn)
+	{
+		if (count == 0)
+			return;
+
+		grainSize = std::max(grainSize, 1u);
+		uint32_t rangeCount = (count + grainSize - 1) / grainSize;
+
+		if (s_Data.Workers.empty() || rangeCount == 1 || t_InsideLoop)
+		{
+			fn(0, count, t_ThreadIndex);
+			return;
+		}
+
+		PHX_PROFILE_FUNCTION();
+
+		std::lock_guard loopLock(s_Data.LoopMutex);
+		t_InsideLoop = true;
+
+		{
+			std::lock_guard lock(s_Data.Mutex);
+			s_Data.Function = &fn;
+			s_Data.Count = count;
+			s_Data.GrainSize = grainSize;
+			s_Data.RangeCount = rangeCount;
+			s_Data.NextRange = 0;
+			s_Data.PendingWorkers = (uint32_t)s_Data.Workers.size();
+			s_Data.Generation++;
+		}
+		s_Data.WakeCondition.notify_all();
+
+		RunRanges(0);
+
+		{
+			std::unique_lock lock(s_Data.Mutex);
+			s_Data.DoneCondition.wait(lock, [] { return s_Data.PendingWorkers == 0; });
+		}
+
+		t_InsideLoop = false;
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <functional>
+
+namespace phx {
+	// Fixed pool of worker threads for data-parallel loops. The calling thread takes part in every loop,
+	// so ParallelFor still works, serially, before Init or on machines with a single core
+	class JobSystem
+	{
+	public:
+		using RangeFn = std::function<void(uint32_t begin, uint32_t end, uint32_t threadIndex)>;
+
+		// workerCount = 0 uses one worker per hardware thread besides the caller
+		static void Init(uint32_t workerCount = 0);
+		static void Shutdown();
+
+		// Threads that can run a loop body at once, including the caller. Every threadIndex is below this
+		static uint32_t GetThreadCount();
+
+		// Splits [0, count) into ranges of grainSize and runs fn on them across all threads, returning once every
+		// range is done. The caller runs as thread 0. Nested calls from inside a body run serially on that thread
+		static void ParallelFor(uint32_t count, uint32_t grainSize, const RangeFn& fn);
+	};
+}
@@ -96,6 +96,23 @@ namespace phx {
 		return result;
 		
 	}
+	bool UI::DrawDragInt(const std::string& label, int* value, float v_speed, int v_min, int v_max, float columnWidth)
+	{
+		ImGui::PushID(label.c_str());
+		ImGui::Columns(2);
+		ImGui::SetColumnWidth(0, columnWidth);
+		ImGui::Text(label.c_str());
+
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
+		bool result = ImGui::DragInt("##DragInt", value, v_speed, v_min, v_max);
+		ImGui::PopItemWidth();
+
+		ImGui::Columns(1);
+		ImGui::PopID();
+
+		return result;
+	}
 	bool UI::DrawDragFloat2(const std::string& label, float value[2], float v_speed, float v_min, float v_max, const char* format, float columnWidth)
 	{
 		ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(ImGui::GetStyle().FramePadding.x, 0));
@@ -22,6 +22,7 @@ namespace phx {
 		
 		static bool DrawButton(const std::string& label, ImVec2 size = ImVec2(0, 0), float columnWidth = 100.0f);
 		static bool DrawDragFloat(const std::string& label, float* value, float v_speed = 1.0f, float v_min = 0.0f, float v_max = 0.0f, const char* format = "%.2f", float columnWidth = 100.0f);
+		static bool DrawDragInt(const std::string& label, int* value, float v_speed = 1.0f, int v_min = 0, int v_max = 0, float columnWidth = 100.0f);
 		static bool DrawDragFloat2(const std::string& label, float value[2], float v_speed = 1.0f, float v_min = 0.0f, float v_max = 0.0f, const char* format = "%.2f", float columnWidth = 100.0f);
 		static bool DrawCheckbox(const std::string& label, bool* value, float columnWidth = 100.0f);
 		static void DrawImage(Ref<Texture2D> image, ImVec2 size);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+namespace phx {
+	// Read-only view of a whole file mapped into memory. The OS pages the contents in on first access, so reading
+	// costs no copy into a buffer of our own
+	class MappedFile
+	{
+	public:
+		MappedFile(const std::string& filepath);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool IsValid() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+	};
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "phxpch.h"
 #include "Phoenix/Renderer/Buffer.h"
 #include "OpenGLBuffer.h"
+#include "OpenGLStateCache.h"
 #include "glad/glad.h"
 
 namespace phx {
@@ -13,7 +14,7 @@ namespace phx {
 		PHX_PROFILE_FUNCTION();
 
 		glCreateBuffers(1, &m_RendererID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
 	}
 
@@ -22,7 +23,7 @@ namespace phx {
 		PHX_PROFILE_FUNCTION();
 
 		glCreateBuffers(1, &m_RendererID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 	}
 
@@ -30,6 +31,7 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
@@ -37,33 +39,149 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 	}
 	void OpenGLVertexBuffer::Unbind() const
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
-	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
+	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	}
+
+	//------------------------------------
+	// STREAMING VERTEX BUFFER DEFINITIONS
+	//------------------------------------
+
+	OpenGLStreamingVertexBuffer::OpenGLStreamingVertexBuffer(uint32_t regionSize, uint32_t regionCount)
+		: m_Size(regionSize * regionCount), m_RegionSize(regionSize)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		PHX_CORE_ASSERT(regionCount > 0, "Streaming vertex buffer needs at least one region!");
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferStorage(m_RendererID, m_Size, nullptr, flags);
+		m_MappedData = (uint8_t*)glMapNamedBufferRange(m_RendererID, 0, m_Size, flags);
+
+		PHX_CORE_ASSERT(m_MappedData, "Failed to persistently map streaming vertex buffer!");
+	}
+
+	OpenGLStreamingVertexBuffer::~OpenGLStreamingVertexBuffer()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		for (const Fence& fence : m_Fences)
+			glDeleteSync(fence.Sync);
+
+		glUnmapNamedBuffer(m_RendererID);
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLStreamingVertexBuffer::Bind() const
+	{
+		PHX_PROFILE_FUNCTION();
+
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+	}
+	void OpenGLStreamingVertexBuffer::Unbind() const
+	{
+		PHX_PROFILE_FUNCTION();
+
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void OpenGLStreamingVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		PHX_CORE_ASSERT(offset + size <= m_RegionSize, "Data does not fit in a streaming region!");
+
+		memcpy((uint8_t*)Map() + offset, data, size);
+	}
+
+	void* OpenGLStreamingVertexBuffer::Map()
+	{
+		// A region never wraps around the end of the ring. What is left past the offset goes unused this lap,
+		// though the fences in it are older than the ones at the start and have to be retired first
+		if (m_RegionOffset + m_RegionSize > m_Size)
+		{
+			WaitForRange(m_RegionOffset, m_Size);
+			m_RegionOffset = 0;
+		}
+
+		WaitForRange(m_RegionOffset, m_RegionOffset + m_RegionSize);
+		return m_MappedData + m_RegionOffset;
+	}
+
+	void OpenGLStreamingVertexBuffer::Advance(uint32_t size)
+	{
+		PHX_CORE_ASSERT(size <= m_RegionSize, "Advanced past the end of a streaming region!");
+
+		if (size == 0)
+			return;
+
+		m_Fences.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), m_RegionOffset, m_RegionOffset + size });
+		m_RegionOffset += size;
+	}
+
+	void OpenGLStreamingVertexBuffer::WaitForRange(uint32_t begin, uint32_t end)
+	{
+		// Fences come in ring order from the current region on, so the overlapping ones are all at the front
+		while (!m_Fences.empty() && m_Fences.front().Begin < end && m_Fences.front().End > begin)
+		{
+			PHX_PROFILE_SCOPE("OpenGLStreamingVertexBuffer::WaitForRange");
+
+			GLsync fence = m_Fences.front().Sync;
+			m_Fences.pop_front();
+
+			// Flush on the first wait so the fence is guaranteed to be submitted, then poll in 1ms steps
+			GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+			while (true)
+			{
+				GLenum result = glClientWaitSync(fence, waitFlags, 1000000);
+				if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+					break;
+				if (result == GL_WAIT_FAILED)
+				{
+					PHX_CORE_ERROR("Failed waiting on streaming vertex buffer fence");
+					break;
+				}
+				waitFlags = 0;
+			}
+
+			glDeleteSync(fence);
+		}
 	}
 
 	//--------------------------
 	// INDEX BUFFER DEFINITIONS
 	//--------------------------
 
+	OpenGLIndexBuffer::OpenGLIndexBuffer(uint16_t* indices, uint32_t count)
+		: m_Count(count), m_Type(IndexType::UInt16)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		glCreateBuffers(1, &m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint16_t), indices, GL_STATIC_DRAW);
+	}
+
 	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t count)
 		: m_Count(count)
 	{
 		PHX_PROFILE_FUNCTION();
 
 		glCreateBuffers(1, &m_RendererID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count, indices, GL_STATIC_DRAW);
+		OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
 	}
 
 	OpenGLIndexBuffer::OpenGLIndexBuffer(Indice* indices, uint32_t count)
@@ -75,6 +193,7 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
@@ -82,12 +201,47 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 	}
 	void OpenGLIndexBuffer::Unbind() const
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+
+	//-----------------------------
+	// INDIRECT BUFFER DEFINITIONS
+	//-----------------------------
+
+	OpenGLIndirectBuffer::OpenGLIndirectBuffer(uint32_t size)
+		: m_Size(size)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		glCreateBuffers(1, &m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	OpenGLIndirectBuffer::~OpenGLIndirectBuffer()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::Bind() const
+	{
+		OpenGLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		PHX_CORE_ASSERT(offset + size <= m_Size, "Indirect buffer overflow!");
+
+		OpenGLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, offset, size, data);
 	}
 }
\ No newline at end of file
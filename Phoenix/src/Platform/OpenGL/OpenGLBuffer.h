@@ -2,6 +2,10 @@
 #include "phxpch.h"
 #include "Phoenix/Renderer/Buffer.h"
 
+#include "glad/glad.h"
+
+#include <deque>
+
 namespace phx {
 	class OpenGLVertexBuffer : public VertexBuffer
 	{
@@ -13,18 +17,58 @@ namespace phx {
 		virtual void Bind() const override;
 		virtual void Unbind() const override;
 
-		virtual void SetData(const void* data, uint32_t size) override;
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+
+		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
+		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+	private:
+		uint32_t m_RendererID;
+		BufferLayout m_Layout;
+	};
+
+	class OpenGLStreamingVertexBuffer : public StreamingVertexBuffer
+	{
+	public:
+		OpenGLStreamingVertexBuffer(uint32_t regionSize, uint32_t regionCount);
+		virtual ~OpenGLStreamingVertexBuffer();
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
 
 		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
 		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+
+		virtual void* Map() override;
+		virtual void Advance(uint32_t size) override;
+
+		virtual uint32_t GetRegionOffset() const override { return m_RegionOffset; }
+		virtual uint32_t GetRegionSize() const override { return m_RegionSize; }
+	private:
+		// Waits for and retires every fence whose range overlaps [begin, end)
+		void WaitForRange(uint32_t begin, uint32_t end);
 	private:
+		struct Fence
+		{
+			GLsync Sync;
+			uint32_t Begin, End;
+		};
+
 		uint32_t m_RendererID;
 		BufferLayout m_Layout;
+
+		uint32_t m_Size;
+		uint32_t m_RegionSize;
+		uint32_t m_RegionOffset = 0;
+		uint8_t* m_MappedData = nullptr;
+		std::deque<Fence> m_Fences; // Oldest first, which is also ring order starting at the current region
 	};
 
 	class OpenGLIndexBuffer : public IndexBuffer
 	{
 	public:
+		OpenGLIndexBuffer(uint16_t* indices, uint32_t count);
 		OpenGLIndexBuffer(uint32_t* indices, uint32_t count);
 		OpenGLIndexBuffer(Indice* indices, uint32_t count);
 
@@ -34,8 +78,25 @@ namespace phx {
 		virtual void Unbind() const;
 
 		virtual uint32_t GetCount() const { return m_Count; }
+		virtual IndexType GetType() const { return m_Type; }
 	private:
 		uint32_t m_RendererID;
 		uint32_t m_Count;
+		IndexType m_Type = IndexType::UInt32;
+	};
+
+	class OpenGLIndirectBuffer : public IndirectBuffer
+	{
+	public:
+		OpenGLIndirectBuffer(uint32_t size);
+		virtual ~OpenGLIndirectBuffer();
+
+		virtual void Bind() const override;
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+		virtual uint32_t GetSize() const override { return m_Size; }
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Size;
 	};
 }
\ No newline at end of file
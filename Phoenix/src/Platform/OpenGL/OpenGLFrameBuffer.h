@@ -2,6 +2,8 @@
 
 #include "Phoenix/Renderer/Framebuffer.h"
 
+#include "glad/glad.h"
+
 namespace phx {
 	class OpenGLFramebuffer : public Framebuffer
 	{
@@ -17,6 +19,9 @@ namespace phx {
 		virtual void Resize(uint32_t width, uint32_t height) override;
 		virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) override;
 
+		virtual bool RequestPixel(uint32_t attachmentIndex, int x, int y) override;
+		virtual bool PollPixel(int& outValue) override;
+
 		virtual void ClearAttachment(uint32_t attachmentIndex, int value) override;
 
 		virtual uint32_t GetColorAttachmentRendererID(uint32_t index = 0) const override { PHX_CORE_ASSERT(index < m_ColorAttachments.size()); return m_ColorAttachments[index]; }
@@ -31,5 +36,16 @@ namespace phx {
 
 		std::vector<uint32_t> m_ColorAttachments;
 		uint32_t m_DepthAttachment = 0;
+
+		// Ring of pixel pack buffers, each read by a fence once the GPU has written it
+		static constexpr uint32_t PixelReadbackCount = 3;
+		struct PixelReadback
+		{
+			uint32_t Buffer = 0;
+			GLsync Fence = nullptr;
+		};
+		PixelReadback m_PixelReadbacks[PixelReadbackCount];
+		uint32_t m_NextPixelRequest = 0;
+		uint32_t m_NextPixelResult = 0;
 	};
 }
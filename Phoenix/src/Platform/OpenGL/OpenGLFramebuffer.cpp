@@ -1,5 +1,6 @@
 #include "phxpch.h"
 #include "OpenGLFramebuffer.h"
+#include "OpenGLStateCache.h"
 
 #include <glad/glad.h>
 
@@ -18,9 +19,10 @@ namespace phx {
 			glCreateTextures(TextureTarget(multisampled), count, outID);
 		}
 
+		// Unit 0 is the active one, which the glTexImage calls below act on
 		static void BindTexture(bool multisampled, uint32_t id)
 		{
-			glBindTexture(TextureTarget(multisampled), id);
+			OpenGLStateCache::BindTextureUnit(0, id);
 		}
 
 		static void AttachColorTexture(uint32_t id, int samples, GLenum internalFormat, GLenum format, uint32_t width, uint32_t height, int index)
@@ -108,8 +110,21 @@ namespace phx {
 	OpenGLFramebuffer::~OpenGLFramebuffer()
 	{
 		glDeleteFramebuffers(1, &m_RendererID);
+		OpenGLStateCache::OnTexturesDeleted(m_ColorAttachments.data(), (uint32_t)m_ColorAttachments.size());
+		OpenGLStateCache::OnTexturesDeleted(&m_DepthAttachment, 1);
 		glDeleteTextures(m_ColorAttachments.size(), m_ColorAttachments.data());
 		glDeleteTextures(1, &m_DepthAttachment);
+
+		for (auto& readback : m_PixelReadbacks)
+		{
+			if (readback.Fence)
+				glDeleteSync(readback.Fence);
+			if (readback.Buffer)
+			{
+				OpenGLStateCache::OnBufferDeleted(readback.Buffer);
+				glDeleteBuffers(1, &readback.Buffer);
+			}
+		}
 	}
 
 	void OpenGLFramebuffer::Invalidate()
@@ -117,6 +132,8 @@ namespace phx {
 		if (m_RendererID)
 		{
 			glDeleteFramebuffers(1, &m_RendererID);
+			OpenGLStateCache::OnTexturesDeleted(m_ColorAttachments.data(), (uint32_t)m_ColorAttachments.size());
+			OpenGLStateCache::OnTexturesDeleted(&m_DepthAttachment, 1);
 			glDeleteTextures(m_ColorAttachments.size(), m_ColorAttachments.data());
 			glDeleteTextures(1, &m_DepthAttachment);
 
@@ -212,6 +229,60 @@ namespace phx {
 		return pixelData;
 
 	}
+
+	bool OpenGLFramebuffer::RequestPixel(uint32_t attachmentIndex, int x, int y)
+	{
+		PHX_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size());
+
+		PixelReadback& readback = m_PixelReadbacks[m_NextPixelRequest % PixelReadbackCount];
+		if (readback.Fence)
+			return false; // Every buffer holds a result not yet polled
+
+		if (!readback.Buffer)
+		{
+			glCreateBuffers(1, &readback.Buffer);
+			glNamedBufferData(readback.Buffer, sizeof(int), nullptr, GL_STREAM_READ);
+		}
+
+		// With a pack buffer bound glReadPixels only queues a copy into it. It is unbound again so the synchronous
+		// ReadPixel keeps reading into client memory
+		glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex);
+		OpenGLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, readback.Buffer);
+		glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, nullptr);
+		OpenGLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		readback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_NextPixelRequest++;
+		return true;
+	}
+
+	bool OpenGLFramebuffer::PollPixel(int& outValue)
+	{
+		PixelReadback& readback = m_PixelReadbacks[m_NextPixelResult % PixelReadbackCount];
+		if (!readback.Fence)
+			return false;
+
+		// Zero timeout never blocks. The flush makes sure the fence is submitted, so it eventually signals
+		GLenum result = glClientWaitSync(readback.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		if (result == GL_TIMEOUT_EXPIRED)
+			return false;
+
+		// A failed wait still ends the request, so later results keep coming back in order
+		if (result == GL_WAIT_FAILED)
+		{
+			PHX_CORE_ERROR("Failed waiting on pixel readback fence");
+			outValue = -1;
+		}
+		else
+		{
+			glGetNamedBufferSubData(readback.Buffer, 0, sizeof(int), &outValue);
+		}
+
+		glDeleteSync(readback.Fence);
+		readback.Fence = nullptr;
+		m_NextPixelResult++;
+		return true;
+	}
 	void OpenGLFramebuffer::ClearAttachment(uint32_t attachmentIndex, int value)
 	{
 		PHX_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size());
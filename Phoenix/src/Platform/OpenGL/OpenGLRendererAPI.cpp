@@ -1,8 +1,14 @@
 #include "phxpch.h"
 #include "OpenGLRendererAPI.h"
+#include "OpenGLStateCache.h"
 #include "glad/glad.h"
 
 namespace phx {
+	static GLenum IndexTypeToOpenGL(IndexType type)
+	{
+		return type == IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
 	void OpenGLRendererAPI::Init()
 	{
 		PHX_PROFILE_FUNCTION();
@@ -10,14 +16,14 @@ namespace phx {
 		glEnable(GL_MULTISAMPLE);
 		//glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 
-		glEnable(GL_DEPTH_TEST);
+		OpenGLStateCache::SetEnabled(GL_DEPTH_TEST, true);
 		//glEnable(GL_CULL_FACE);
 		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 		glFrontFace(GL_CCW);
 
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		OpenGLStateCache::SetEnabled(GL_BLEND, true);
+		OpenGLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 		RenderAPICapabilities& caps = RendererAPI::GetCapabilities();
 
@@ -45,20 +51,49 @@ namespace phx {
 	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount)
 	{
 		vertexArray->Bind();
-		uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
-		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+		const Ref<IndexBuffer>& indexBuffer = vertexArray->GetIndexBuffer();
+		uint32_t count = indexCount ? indexCount : indexBuffer->GetCount();
+		glDrawElements(GL_TRIANGLES, count, IndexTypeToOpenGL(indexBuffer->GetType()), nullptr);
 	}
 	void OpenGLRendererAPI::DrawIndexed(unsigned int count)
 	{
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
 	}
-	void OpenGLRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+	void OpenGLRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance, uint32_t firstIndex)
+	{
+		vertexArray->Bind();
+		IndexType type = vertexArray->GetIndexBuffer()->GetType();
+		const void* offset = (const void*)((size_t)firstIndex * IndexTypeSize(type));
+		glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, IndexTypeToOpenGL(type), offset, instanceCount, baseInstance);
+	}
+	void OpenGLRendererAPI::DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t firstDraw)
+	{
+		vertexArray->Bind();
+		indirectBuffer->Bind();
+		IndexType type = vertexArray->GetIndexBuffer()->GetType();
+		const void* offset = (const void*)((size_t)firstDraw * sizeof(DrawIndexedIndirectCommand));
+		glMultiDrawElementsIndirect(GL_TRIANGLES, IndexTypeToOpenGL(type), offset, drawCount, sizeof(DrawIndexedIndirectCommand));
+	}
+	void OpenGLRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex)
 	{
 		vertexArray->Bind();
-		glDrawArrays(GL_LINES, 0, vertexCount);
+		glDrawArrays(GL_LINES, firstVertex, vertexCount);
+	}
+	RendererAPI::StateStatistics OpenGLRendererAPI::GetStateStats() const
+	{
+		OpenGLStateCache::Statistics stats = OpenGLStateCache::GetStats();
+		return { stats.IssuedCalls, stats.ElidedCalls };
+	}
+	void OpenGLRendererAPI::ResetStateStats()
+	{
+		OpenGLStateCache::ResetStats();
 	}
 	void OpenGLRendererAPI::SetLineWidth(float width)
 	{
-		glLineWidth(width);
+		OpenGLStateCache::LineWidth(width);
+	}
+	void OpenGLRendererAPI::SetDepthRange(float nearDepth, float farDepth)
+	{
+		OpenGLStateCache::DepthRange(nearDepth, farDepth);
 	}
 }
\ No newline at end of file
@@ -14,9 +14,15 @@ namespace phx {
 
 		virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount) override;
 		virtual void DrawIndexed(unsigned int count) override;
+		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance, uint32_t firstIndex) override;
+		virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t firstDraw) override;
 
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
+		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex) override;
 
 		virtual void SetLineWidth(float width) override;
+		virtual void SetDepthRange(float nearDepth, float farDepth) override;
+
+		virtual StateStatistics GetStateStats() const override;
+		virtual void ResetStateStats() override;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
  #include "phxpch.h"
 #include "Platform/OpenGL/OpenGLShader.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 
 #include <fstream>
 #include <filesystem>
@@ -153,6 +154,7 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnProgramDeleted(m_RendererID);
 		glDeleteProgram(m_RendererID);
 	}
 
@@ -366,6 +368,7 @@ namespace phx {
 		}
 
 		m_RendererID = program;
+		ReflectUniformLocations();
 	}
 
 	void OpenGLShader::Reflect(GLenum stage, const std::vector<uint32_t>& shaderData)
@@ -392,18 +395,44 @@ namespace phx {
 		}
 	}
 
+	void OpenGLShader::ReflectUniformLocations()
+	{
+		m_UniformLocations.clear();
+
+		// Uniforms outside blocks carry their location in the OpenGL SPIR-V. Arrays are also reachable through
+		// their first element, which is how glGetUniformLocation names them
+		for (auto&& [stage, spirv] : m_OpenGLSPIRV)
+		{
+			spirv_cross::Compiler compiler(spirv);
+			for (auto id : compiler.get_active_interface_variables())
+			{
+				if (compiler.get_storage_class(id) != spv::StorageClassUniformConstant || !compiler.has_decoration(id, spv::DecorationLocation))
+					continue;
+
+				const std::string& name = compiler.get_name(id);
+				if (name.empty())
+					continue;
+
+				int32_t location = (int32_t)compiler.get_decoration(id, spv::DecorationLocation);
+				m_UniformLocations[name] = location;
+				if (!compiler.get_type_from_variable(id).array.empty())
+					m_UniformLocations[name + "[0]"] = location;
+			}
+		}
+	}
+
 	void OpenGLShader::Bind() const
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glUseProgram(m_RendererID);
+		OpenGLStateCache::UseProgram(m_RendererID);
 	}
 
 	void OpenGLShader::Unbind() const
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glUseProgram(0);
+		OpenGLStateCache::UseProgram(0);
 	}
 
 	void OpenGLShader::SetInt(const std::string& name, int value)
@@ -453,52 +482,90 @@ namespace phx {
 		UploadUniformMat4(name, value);
 	}
 
-	void OpenGLShader::UploadUniformInt(const std::string& name, int value)
+	Shader::UniformHandle OpenGLShader::GetUniformHandle(const std::string& name) const
 	{
+		auto it = m_UniformLocations.find(name);
+		if (it != m_UniformLocations.end())
+			return it->second;
+
 		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1i(location, value);
+		m_UniformLocations.emplace(name, location);
+		return location;
+	}
+
+	void OpenGLShader::SetInt(UniformHandle handle, int value)
+	{
+		glUniform1i(handle, value);
+	}
+
+	void OpenGLShader::SetIntArray(UniformHandle handle, int* values, uint32_t count)
+	{
+		glUniform1iv(handle, count, values);
+	}
+
+	void OpenGLShader::SetFloat(UniformHandle handle, float value)
+	{
+		glUniform1f(handle, value);
+	}
+
+	void OpenGLShader::SetVec2(UniformHandle handle, const glm::vec2& value)
+	{
+		glUniform2f(handle, value.x, value.y);
+	}
+
+	void OpenGLShader::SetVec3(UniformHandle handle, const glm::vec3& value)
+	{
+		glUniform3f(handle, value.x, value.y, value.z);
+	}
+
+	void OpenGLShader::SetVec4(UniformHandle handle, const glm::vec4& value)
+	{
+		glUniform4f(handle, value.x, value.y, value.z, value.w);
+	}
+
+	void OpenGLShader::SetMat4(UniformHandle handle, const glm::mat4& value)
+	{
+		glUniformMatrix4fv(handle, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	void OpenGLShader::UploadUniformInt(const std::string& name, int value)
+	{
+		glUniform1i(GetUniformHandle(name), value);
 	}
 
 	void OpenGLShader::UploadUniformIntArray(const std::string& name, int* values, uint32_t count)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1iv(location, count, values);
+		glUniform1iv(GetUniformHandle(name), count, values);
 	}
 
 	void OpenGLShader::UploadUniformFloat(const std::string& name, float value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1f(location, value);
+		glUniform1f(GetUniformHandle(name), value);
 	}
 
 	void OpenGLShader::UploadUniformVec2(const std::string& name, const glm::vec2& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform2f(location, value.x, value.y);
+		glUniform2f(GetUniformHandle(name), value.x, value.y);
 	}
 
 	void OpenGLShader::UploadUniformVec3(const std::string& name, const glm::vec3& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform3f(location, value.x, value.y, value.z);
+		glUniform3f(GetUniformHandle(name), value.x, value.y, value.z);
 	}
 
 	void OpenGLShader::UploadUniformVec4(const std::string& name, const glm::vec4& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform4f(location, value.x, value.y, value.z, value.w);
+		glUniform4f(GetUniformHandle(name), value.x, value.y, value.z, value.w);
 	}
 
 	void OpenGLShader::UploadUniformMat3(const std::string& name, const glm::mat3& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		glUniformMatrix3fv(GetUniformHandle(name), 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
 	void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		glUniformMatrix4fv(GetUniformHandle(name), 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
 }
\ No newline at end of file
@@ -26,7 +26,18 @@ namespace phx {
 		virtual void SetVec4(const std::string& name, const glm::vec4& value) override;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) override;
 
+		virtual UniformHandle GetUniformHandle(const std::string& name) const override;
+
+		virtual void SetInt(UniformHandle handle, int value) override;
+		virtual void SetIntArray(UniformHandle handle, int* values, uint32_t count) override;
+		virtual void SetFloat(UniformHandle handle, float value) override;
+		virtual void SetVec2(UniformHandle handle, const glm::vec2& value) override;
+		virtual void SetVec3(UniformHandle handle, const glm::vec3& value) override;
+		virtual void SetVec4(UniformHandle handle, const glm::vec4& value) override;
+		virtual void SetMat4(UniformHandle handle, const glm::mat4& value) override;
+
 		virtual const std::string& GetName() const override { return m_Name; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
 
 		void UploadUniformInt(const std::string& name, int value);
 		void UploadUniformIntArray(const std::string& name, int* values, uint32_t count);
@@ -47,6 +58,7 @@ namespace phx {
 		void CompileOrGetOpenGLBinaries();
 		void CreateProgram();
 		void Reflect(GLenum stage, const std::vector<uint32_t>& shaderData);
+		void ReflectUniformLocations();
 
 		uint32_t m_RendererID;
 		std::string m_FilePath;
@@ -56,6 +68,10 @@ namespace phx {
 		std::unordered_map<GLenum, std::vector<uint32_t>> m_OpenGLSPIRV;
 
 		std::unordered_map<GLenum, std::string> m_OpenGLSourceCode;
+
+		// Filled from the OpenGL SPIR-V when the program is created. Names reflection missed are queried from the
+		// driver on first use, misses included, so no name reaches glGetUniformLocation twice
+		mutable std::unordered_map<std::string, int32_t> m_UniformLocations;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "phxpch.h"
+#include "OpenGLStateCache.h"
+
+namespace phx {
+
+	namespace {
+		constexpr uint32_t Unknown = ~0u;
+
+		enum BufferTarget { ArrayBuffer = 0, DrawIndirectBuffer, PixelPackBuffer, PixelUnpackBuffer, BufferTargetCount };
+		enum Capability { Blend = 0, DepthTest, CullFace, CapabilityCount };
+
+		int BufferTargetIndex(GLenum target)
+		{
+			switch (target)
+			{
+			case GL_ARRAY_BUFFER:          return ArrayBuffer;
+			case GL_DRAW_INDIRECT_BUFFER:  return DrawIndirectBuffer;
+			case GL_PIXEL_PACK_BUFFER:     return PixelPackBuffer;
+			case GL_PIXEL_UNPACK_BUFFER:   return PixelUnpackBuffer;
+			}
+			return -1;
+		}
+
+		int CapabilityIndex(GLenum capability)
+		{
+			switch (capability)
+			{
+			case GL_BLEND:       return Blend;
+			case GL_DEPTH_TEST:  return DepthTest;
+			case GL_CULL_FACE:   return CullFace;
+			}
+			return -1;
+		}
+	}
+
+	struct OpenGLStateCacheData
+	{
+		uint32_t Program = Unknown;
+		uint32_t VertexArray = Unknown;
+		uint32_t Buffers[BufferTargetCount];
+		uint32_t TextureUnits[OpenGLStateCache::MaxTextureUnits];
+
+		int8_t Capabilities[CapabilityCount]; // -1 unknown
+		GLenum BlendSource = Unknown, BlendDestination = Unknown;
+		GLenum DepthFunction = Unknown;
+		int8_t DepthWrite = -1;
+		float DepthNear = -1.0f, DepthFar = -1.0f;
+		float LineWidth = -1.0f;
+
+		OpenGLStateCache::Statistics Stats;
+
+		OpenGLStateCacheData() { Reset(); }
+
+		void Reset()
+		{
+			Program = VertexArray = Unknown;
+			std::fill(std::begin(Buffers), std::end(Buffers), Unknown);
+			std::fill(std::begin(TextureUnits), std::end(TextureUnits), Unknown);
+			std::fill(std::begin(Capabilities), std::end(Capabilities), (int8_t)-1);
+			BlendSource = BlendDestination = DepthFunction = Unknown;
+			DepthWrite = -1;
+			DepthNear = DepthFar = -1.0f;
+			LineWidth = -1.0f;
+		}
+
+		// Returns true when the call has to be issued, and records the new value
+		template<typename T>
+		bool Change(T& current, T value)
+		{
+			if (current == value)
+			{
+				Stats.ElidedCalls++;
+				return false;
+			}
+
+			current = value;
+			Stats.IssuedCalls++;
+			return true;
+		}
+	};
+
+	static OpenGLStateCacheData s_State;
+
+	void OpenGLStateCache::UseProgram(uint32_t program)
+	{
+		if (s_State.Change(s_State.Program, program))
+			glUseProgram(program);
+	}
+
+	void OpenGLStateCache::BindVertexArray(uint32_t vertexArray)
+	{
+		if (s_State.Change(s_State.VertexArray, vertexArray))
+			glBindVertexArray(vertexArray);
+	}
+
+	void OpenGLStateCache::BindBuffer(GLenum target, uint32_t buffer)
+	{
+		int index = BufferTargetIndex(target);
+		if (index < 0)
+		{
+			s_State.Stats.IssuedCalls++;
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		if (s_State.Change(s_State.Buffers[index], buffer))
+			glBindBuffer(target, buffer);
+	}
+
+	void OpenGLStateCache::BindTextureUnit(uint32_t unit, uint32_t texture)
+	{
+		if (unit >= MaxTextureUnits)
+		{
+			s_State.Stats.IssuedCalls++;
+			glBindTextureUnit(unit, texture);
+			return;
+		}
+
+		if (s_State.Change(s_State.TextureUnits[unit], texture))
+			glBindTextureUnit(unit, texture);
+	}
+
+	void OpenGLStateCache::SetEnabled(GLenum capability, bool enabled)
+	{
+		int index = CapabilityIndex(capability);
+		if (index >= 0 && !s_State.Change(s_State.Capabilities[index], (int8_t)enabled))
+			return;
+		if (index < 0)
+			s_State.Stats.IssuedCalls++;
+
+		if (enabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+
+	void OpenGLStateCache::BlendFunc(GLenum source, GLenum destination)
+	{
+		if (s_State.BlendSource == source && s_State.BlendDestination == destination)
+		{
+			s_State.Stats.ElidedCalls++;
+			return;
+		}
+
+		s_State.BlendSource = source;
+		s_State.BlendDestination = destination;
+		s_State.Stats.IssuedCalls++;
+		glBlendFunc(source, destination);
+	}
+
+	void OpenGLStateCache::DepthFunc(GLenum function)
+	{
+		if (s_State.Change(s_State.DepthFunction, function))
+			glDepthFunc(function);
+	}
+
+	void OpenGLStateCache::DepthMask(bool write)
+	{
+		if (s_State.Change(s_State.DepthWrite, (int8_t)write))
+			glDepthMask(write ? GL_TRUE : GL_FALSE);
+	}
+
+	void OpenGLStateCache::DepthRange(float nearDepth, float farDepth)
+	{
+		if (s_State.DepthNear == nearDepth && s_State.DepthFar == farDepth)
+		{
+			s_State.Stats.ElidedCalls++;
+			return;
+		}
+
+		s_State.DepthNear = nearDepth;
+		s_State.DepthFar = farDepth;
+		s_State.Stats.IssuedCalls++;
+		glDepthRange(nearDepth, farDepth);
+	}
+
+	void OpenGLStateCache::LineWidth(float width)
+	{
+		if (s_State.Change(s_State.LineWidth, width))
+			glLineWidth(width);
+	}
+
+	void OpenGLStateCache::OnProgramDeleted(uint32_t program)
+	{
+		if (s_State.Program == program)
+			s_State.Program = Unknown;
+	}
+
+	void OpenGLStateCache::OnVertexArrayDeleted(uint32_t vertexArray)
+	{
+		if (s_State.VertexArray == vertexArray)
+			s_State.VertexArray = 0;
+	}
+
+	void OpenGLStateCache::OnBufferDeleted(uint32_t buffer)
+	{
+		for (uint32_t& bound : s_State.Buffers)
+			if (bound == buffer)
+				bound = 0;
+	}
+
+	void OpenGLStateCache::OnTexturesDeleted(const uint32_t* textures, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+			for (uint32_t& bound : s_State.TextureUnits)
+				if (bound == textures[i])
+					bound = 0;
+	}
+
+	void OpenGLStateCache::Invalidate()
+	{
+		s_State.Reset();
+	}
+
+	OpenGLStateCache::Statistics OpenGLStateCache::GetStats()
+	{
+		return s_State.Stats;
+	}
+
+	void OpenGLStateCache::ResetStats()
+	{
+		s_State.Stats = {};
+	}
+}
\ No newline at end of file
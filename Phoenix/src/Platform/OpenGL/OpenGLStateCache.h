@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace phx {
+	// Mirror of the GL state the backend changes most often. Each call compares against the last value set through
+	// the cache and skips the GL call when nothing would change. The backend must change this state only through
+	// here, and report deletions so a reused name is never taken for one that is still bound. Code outside the
+	// backend that touches the same state, like the ImGui renderer, has to restore it afterwards or call Invalidate
+	class OpenGLStateCache
+	{
+	public:
+		static constexpr uint32_t MaxTextureUnits = 32;
+
+		static void UseProgram(uint32_t program);
+		static void BindVertexArray(uint32_t vertexArray);
+		// Element array bindings belong to the bound vertex array, so they are always issued
+		static void BindBuffer(GLenum target, uint32_t buffer);
+		static void BindTextureUnit(uint32_t unit, uint32_t texture);
+
+		static void SetEnabled(GLenum capability, bool enabled);
+		static void BlendFunc(GLenum source, GLenum destination);
+		static void DepthFunc(GLenum function);
+		static void DepthMask(bool write);
+		static void DepthRange(float nearDepth, float farDepth);
+		static void LineWidth(float width);
+
+		static void OnProgramDeleted(uint32_t program);
+		static void OnVertexArrayDeleted(uint32_t vertexArray);
+		static void OnBufferDeleted(uint32_t buffer);
+		static void OnTexturesDeleted(const uint32_t* textures, uint32_t count);
+
+		// Forgets everything, so the next call of every kind is issued
+		static void Invalidate();
+
+		struct Statistics
+		{
+			uint32_t IssuedCalls = 0;
+			uint32_t ElidedCalls = 0;
+		};
+		static Statistics GetStats();
+		static void ResetStats();
+	};
+}
\ No newline at end of file
@@ -1,9 +1,20 @@
 #include "phxpch.h"
 #include "OpenGLTexture.h"
+#include "OpenGLStateCache.h"
 
 #include "stb_image.h"
 
 namespace phx {
+	static bool HasTranslucentTexels(const uint8_t* rgba, uint32_t texelCount)
+	{
+		for (uint32_t i = 0; i < texelCount; i++)
+		{
+			if (rgba[i * 4 + 3] != 0xFF)
+				return true;
+		}
+		return false;
+	}
+
 	OpenGLTexture2D::OpenGLTexture2D(const std::string& path)
 		: m_Path(path)
 	{
@@ -41,6 +52,7 @@ namespace phx {
 
 			m_InternalFormat = internalFormat;
 			m_DataFormat = dataFormat;
+			m_IsTranslucent = channels == 4 && HasTranslucentTexels(data, m_Width * m_Height);
 
 			PHX_CORE_ASSERT(internalFormat & dataFormat, "Format not supported!");
 
@@ -84,6 +96,7 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnTexturesDeleted(&m_RendererID, 1);
 		glDeleteTextures(1, &m_RendererID);
 	}
 
@@ -93,13 +106,119 @@ namespace phx {
 
 		uint32_t bpp = m_DataFormat == GL_RGBA ? 4 : 3;
 		PHX_CORE_ASSERT(size == m_Width * m_Height * bpp, "Data must be entire texture");
+		m_IsTranslucent = bpp == 4 && HasTranslucentTexels((const uint8_t*)data, m_Width * m_Height);
 		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+		m_Version++;
 	}
 
 	void OpenGLTexture2D::Bind(uint32_t slot) const
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glBindTextureUnit(slot, m_RendererID);
+		OpenGLStateCache::BindTextureUnit(slot, m_RendererID);
+	}
+
+	OpenGLTexture2DArray::OpenGLTexture2DArray(uint32_t width, uint32_t height, uint32_t layers)
+		: m_Width(width), m_Height(height), m_LayerCount(layers)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_RendererID);
+		glTextureStorage3D(m_RendererID, 1, GL_RGBA8, m_Width, m_Height, m_LayerCount);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	}
+
+	OpenGLTexture2DArray::~OpenGLTexture2DArray()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		OpenGLStateCache::OnTexturesDeleted(&m_RendererID, 1);
+		glDeleteTextures(1, &m_RendererID);
+	}
+
+	void OpenGLTexture2DArray::CopyToLayer(const Ref<Texture2D>& texture, uint32_t layer)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		PHX_CORE_ASSERT(texture->GetWidth() == m_Width && texture->GetHeight() == m_Height, "Texture size does not match the array!");
+		PHX_CORE_ASSERT(layer < m_LayerCount, "Layer out of range!");
+
+		// Source textures may be RGB8, which glCopyImageSubData cannot copy into RGBA8, so go through a blit instead
+		uint32_t framebuffers[2];
+		glCreateFramebuffers(2, framebuffers);
+		glNamedFramebufferTexture(framebuffers[0], GL_COLOR_ATTACHMENT0, texture->GetRendererID(), 0);
+		glNamedFramebufferTextureLayer(framebuffers[1], GL_COLOR_ATTACHMENT0, m_RendererID, 0, layer);
+
+		glBlitNamedFramebuffer(framebuffers[0], framebuffers[1],
+			0, 0, m_Width, m_Height,
+			0, 0, m_Width, m_Height,
+			GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+		glDeleteFramebuffers(2, framebuffers);
+	}
+
+	void OpenGLTexture2DArray::CopyLayers(const Ref<Texture2DArray>& source, uint32_t layerCount)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		PHX_CORE_ASSERT(source->GetWidth() == m_Width && source->GetHeight() == m_Height, "Texture array sizes do not match!");
+		PHX_CORE_ASSERT(layerCount <= m_LayerCount && layerCount <= source->GetLayerCount(), "Layer count out of range!");
+
+		glCopyImageSubData(source->GetRendererID(), GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			m_RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			m_Width, m_Height, layerCount);
+	}
+
+	void OpenGLTexture2DArray::Bind(uint32_t slot) const
+	{
+		PHX_PROFILE_FUNCTION();
+
+		OpenGLStateCache::BindTextureUnit(slot, m_RendererID);
+	}
+
+	OpenGLIndexTexture2D::OpenGLIndexTexture2D(uint32_t width, uint32_t height)
+		: m_Width(width), m_Height(height)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
+		glTextureStorage2D(m_RendererID, 1, GL_R16UI, m_Width, m_Height);
+
+		// Integer textures cannot be filtered
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	OpenGLIndexTexture2D::~OpenGLIndexTexture2D()
+	{
+		PHX_PROFILE_FUNCTION();
+
+		OpenGLStateCache::OnTexturesDeleted(&m_RendererID, 1);
+		glDeleteTextures(1, &m_RendererID);
+	}
+
+	void OpenGLIndexTexture2D::SetData(const uint16_t* data)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		// Rows of an odd width are not 4-byte aligned
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, GL_RED_INTEGER, GL_UNSIGNED_SHORT, data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	void OpenGLIndexTexture2D::Bind(uint32_t slot) const
+	{
+		PHX_PROFILE_FUNCTION();
+
+		OpenGLStateCache::BindTextureUnit(slot, m_RendererID);
 	}
 }
\ No newline at end of file
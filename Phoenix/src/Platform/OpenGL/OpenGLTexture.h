@@ -20,6 +20,9 @@ namespace phx {
 		virtual void Bind(uint32_t slot = 0) const override;
 
 		virtual bool IsLoaded() const override { return m_IsLoaded; }
+		virtual bool HasAlphaChannel() const override { return m_DataFormat == GL_RGBA; }
+		virtual bool IsTranslucent() const override { return m_IsTranslucent; }
+		virtual uint32_t GetVersion() const override { return m_Version; }
 
 		virtual std::string GetPath() const override { return m_Path; }
 
@@ -30,8 +33,48 @@ namespace phx {
 	private:
 		std::string m_Path = "";
 		bool m_IsLoaded = false;
+		bool m_IsTranslucent = false;
+		uint32_t m_Version = 0;
 		uint32_t m_Width, m_Height;
 		uint32_t m_RendererID;
 		GLenum m_InternalFormat, m_DataFormat;
 	};
+
+	class OpenGLTexture2DArray : public Texture2DArray
+	{
+	public:
+		OpenGLTexture2DArray(uint32_t width, uint32_t height, uint32_t layers);
+		virtual ~OpenGLTexture2DArray();
+
+		virtual uint32_t GetWidth() const override { return m_Width; }
+		virtual uint32_t GetHeight() const override { return m_Height; }
+		virtual uint32_t GetLayerCount() const override { return m_LayerCount; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+
+		virtual void CopyToLayer(const Ref<Texture2D>& texture, uint32_t layer) override;
+		virtual void CopyLayers(const Ref<Texture2DArray>& source, uint32_t layerCount) override;
+
+		virtual void Bind(uint32_t slot = 0) const override;
+	private:
+		uint32_t m_Width, m_Height, m_LayerCount;
+		uint32_t m_RendererID;
+	};
+
+	class OpenGLIndexTexture2D : public IndexTexture2D
+	{
+	public:
+		OpenGLIndexTexture2D(uint32_t width, uint32_t height);
+		virtual ~OpenGLIndexTexture2D();
+
+		virtual uint32_t GetWidth() const override { return m_Width; }
+		virtual uint32_t GetHeight() const override { return m_Height; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+
+		virtual void SetData(const uint16_t* data) override;
+
+		virtual void Bind(uint32_t slot = 0) const override;
+	private:
+		uint32_t m_Width, m_Height;
+		uint32_t m_RendererID;
+	};
 }
\ No newline at end of file
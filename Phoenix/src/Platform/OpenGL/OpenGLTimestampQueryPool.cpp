@@ -0,0 +1,51 @@
+#include "phxpch.h"
+#include "OpenGLTimestampQueryPool.h"
+
+#include <glad/glad.h>
+
+namespace phx {
+
+	OpenGLTimestampQueryPool::OpenGLTimestampQueryPool(uint32_t capacity)
+		: m_Queries(capacity)
+	{
+		glCreateQueries(GL_TIMESTAMP, capacity, m_Queries.data());
+	}
+
+	OpenGLTimestampQueryPool::~OpenGLTimestampQueryPool()
+	{
+		glDeleteQueries((GLsizei)m_Queries.size(), m_Queries.data());
+	}
+
+	uint32_t OpenGLTimestampQueryPool::Write()
+	{
+		if (m_WrittenCount == m_Queries.size())
+			return InvalidQuery;
+
+		glQueryCounter(m_Queries[m_WrittenCount], GL_TIMESTAMP);
+		return m_WrittenCount++;
+	}
+
+	bool OpenGLTimestampQueryPool::TryRead(uint64_t* outNanoseconds)
+	{
+		if (m_WrittenCount == 0)
+			return true;
+
+		// Queries finish in order, so once the last one is available all of them are
+		GLint available = 0;
+		glGetQueryObjectiv(m_Queries[m_WrittenCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+
+		for (uint32_t i = 0; i < m_WrittenCount; i++)
+			glGetQueryObjectui64v(m_Queries[i], GL_QUERY_RESULT, &outNanoseconds[i]);
+		return true;
+	}
+
+	uint64_t OpenGLTimestampQueryPool::GetCurrentTimestamp() const
+	{
+		GLint64 time = 0;
+		glGetInteger64v(GL_TIMESTAMP, &time);
+		return (uint64_t)time;
+	}
+
+}
\ No newline at end of file
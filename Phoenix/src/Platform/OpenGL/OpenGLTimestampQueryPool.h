@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Phoenix/Renderer/TimestampQueryPool.h"
+
+namespace phx {
+
+	class OpenGLTimestampQueryPool : public TimestampQueryPool
+	{
+	public:
+		OpenGLTimestampQueryPool(uint32_t capacity);
+		virtual ~OpenGLTimestampQueryPool();
+
+		virtual uint32_t Write() override;
+		virtual uint32_t GetWrittenCount() const override { return m_WrittenCount; }
+		virtual bool TryRead(uint64_t* outNanoseconds) override;
+		virtual void Reset() override { m_WrittenCount = 0; }
+
+		virtual uint64_t GetCurrentTimestamp() const override;
+	private:
+		std::vector<uint32_t> m_Queries;
+		uint32_t m_WrittenCount = 0;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "phxpch.h"
 #include "OpenGLUniformBuffer.h"
+#include "OpenGLStateCache.h"
 
 #include <glad/glad.h>
 
@@ -14,6 +15,7 @@ namespace phx {
 
 	OpenGLUniformBuffer::~OpenGLUniformBuffer()
 	{
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
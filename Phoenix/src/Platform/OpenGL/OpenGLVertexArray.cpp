@@ -1,5 +1,6 @@
 #include "phxpch.h"
 #include "OpenGLVertexArray.h"
+#include "OpenGLStateCache.h"
 
 #include "glad/glad.h"
 
@@ -19,6 +20,10 @@ namespace phx {
 		case phx::ShaderDataType::int3: return GL_INT;
 		case phx::ShaderDataType::int4: return GL_INT;
 		case phx::ShaderDataType::Bool: return GL_BOOL;
+		case phx::ShaderDataType::ubyte4: return GL_UNSIGNED_BYTE;
+		case phx::ShaderDataType::ushort2: return GL_UNSIGNED_SHORT;
+		case phx::ShaderDataType::ushort4: return GL_UNSIGNED_SHORT;
+		case phx::ShaderDataType::half2: return GL_HALF_FLOAT;
 		}
 	}
 	OpenGLVertexArray::OpenGLVertexArray()
@@ -32,6 +37,7 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnVertexArrayDeleted(m_RendererID);
 		glDeleteVertexArrays(1, &m_RendererID);
 	}
 
@@ -39,26 +45,37 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 	}
 
 	void OpenGLVertexArray::Unbind() const
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glBindVertexArray(0);
+		OpenGLStateCache::BindVertexArray(0);
 	}
 
 	void OpenGLVertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer)
 	{
 		PHX_PROFILE_FUNCTION();
 
+		AddAttributes(vertexBuffer, false);
+	}
+
+	void OpenGLVertexArray::AddInstanceBuffer(const std::shared_ptr<VertexBuffer>& instanceBuffer)
+	{
+		PHX_PROFILE_FUNCTION();
+
+		AddAttributes(instanceBuffer, true);
+	}
+
+	void OpenGLVertexArray::AddAttributes(const std::shared_ptr<VertexBuffer>& vertexBuffer, bool perInstance)
+	{
 		PHX_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
 
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		vertexBuffer->Bind();
 
-		uint32_t index = 0;
 		const auto& layout = vertexBuffer->GetLayout();
 		for (const auto& element : layout)
 		{
@@ -68,15 +85,18 @@ namespace phx {
 				case ShaderDataType::vec2:
 				case ShaderDataType::vec3:
 				case ShaderDataType::vec4:
+				case ShaderDataType::half2:
 				{
-					glEnableVertexAttribArray(index);
-					glVertexAttribPointer(index,
+					glEnableVertexAttribArray(m_VertexBufferIndex);
+					glVertexAttribPointer(m_VertexBufferIndex,
 						element.GetComponentCount(),
 						ShaderTypeToOpenGLType(element.Type),
 						element.Normalized ? GL_TRUE : GL_FALSE,
 						layout.GetStride(),
-						(const void*)element.Offset);
-					index++;
+						(const void*)(uintptr_t)element.Offset);
+					if (perInstance)
+						glVertexAttribDivisor(m_VertexBufferIndex, 1);
+					m_VertexBufferIndex++;
 					break;
 				}
 				case ShaderDataType::Int:
@@ -85,13 +105,43 @@ namespace phx {
 				case ShaderDataType::int4:
 				case ShaderDataType::Bool:
 				{
-					glEnableVertexAttribArray(index);
-					glVertexAttribIPointer(index,
+					glEnableVertexAttribArray(m_VertexBufferIndex);
+					glVertexAttribIPointer(m_VertexBufferIndex,
 						element.GetComponentCount(),
 						ShaderTypeToOpenGLType(element.Type),
 						layout.GetStride(),
-						(const void*)element.Offset);
-					index++;
+						(const void*)(uintptr_t)element.Offset);
+					if (perInstance)
+						glVertexAttribDivisor(m_VertexBufferIndex, 1);
+					m_VertexBufferIndex++;
+					break;
+				}
+				case ShaderDataType::ubyte4:
+				case ShaderDataType::ushort2:
+				case ShaderDataType::ushort4:
+				{
+					// Normalized elements read as floats, the rest as integers
+					glEnableVertexAttribArray(m_VertexBufferIndex);
+					if (element.Normalized)
+					{
+						glVertexAttribPointer(m_VertexBufferIndex,
+							element.GetComponentCount(),
+							ShaderTypeToOpenGLType(element.Type),
+							GL_TRUE,
+							layout.GetStride(),
+							(const void*)(uintptr_t)element.Offset);
+					}
+					else
+					{
+						glVertexAttribIPointer(m_VertexBufferIndex,
+							element.GetComponentCount(),
+							ShaderTypeToOpenGLType(element.Type),
+							layout.GetStride(),
+							(const void*)(uintptr_t)element.Offset);
+					}
+					if (perInstance)
+						glVertexAttribDivisor(m_VertexBufferIndex, 1);
+					m_VertexBufferIndex++;
 					break;
 				}
 				case ShaderDataType::mat3:
@@ -100,15 +150,15 @@ namespace phx {
 					uint8_t count = element.GetComponentCount();
 					for (uint8_t i = 0; i < count; i++)
 					{
-						glEnableVertexAttribArray(index);
-						glVertexAttribPointer(index,
+						glEnableVertexAttribArray(m_VertexBufferIndex);
+						glVertexAttribPointer(m_VertexBufferIndex,
 							count,
 							ShaderTypeToOpenGLType(element.Type),
 							element.Normalized ? GL_TRUE : GL_FALSE,
 							layout.GetStride(),
-							(const void*)(sizeof(float) * count * i));
-						glVertexAttribDivisor(index, 1);
-						index++;
+							(const void*)(uintptr_t)(element.Offset + sizeof(float) * count * i));
+						glVertexAttribDivisor(m_VertexBufferIndex, 1);
+						m_VertexBufferIndex++;
 					}
 					break;
 				}
@@ -124,7 +174,7 @@ namespace phx {
 	{
 		PHX_PROFILE_FUNCTION();
 
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		indexBuffer->Bind();
 
 		m_IndexBuffer = indexBuffer;